@@ -0,0 +1,35 @@
+/**
+ * LedControlDC library is developed on the basis of 
+ * LedControl for working with dual color seven segment indicators
+ * 
+ * Color blending: a level 0..99 shown in hues from green (low)
+ * through yellow and amber to red (high)
+ */
+#include <LedControlDC.h>
+LedControlDC lc=LedControlDC(12,11,10);//DataIn, CLK, Load 
+
+void setup() {
+  lc.shutdown(0,false);
+  lc.setIntensity(0,15);
+  lc.clearDisplay(0);
+}
+
+uint32_t ms0 = 0;
+uint32_t ms1 = 0;
+int level = 0;
+
+void loop() { 
+  uint32_t ms = millis();
+// Blending needs a steady tick, one device takes one every millisecond
+  if( ms != ms0 ){
+    ms0 = ms;
+    lc.tick();
+  }
+// A new level every 200 ms
+  if( ms - ms1 < 200 )return;
+  ms1 = ms;
+  if( ++level > 99 )level = 0;
+  lc.printNumber(level,0,DC_ORANGE);
+// 0 -> red 1/16, 99 -> red 15/16
+  lc.setBlend(0,1+level*15/100);
+}
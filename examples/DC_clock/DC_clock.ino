@@ -26,13 +26,15 @@ void setup() {
 
 void loop() { 
    ms = millis();
-   if( ms0 == 0 || ms0 > ms || (ms-ms0)>500 ){      
+// Animations run step by step from here, loop() is never blocked
+   bool idle = lc.update(ms);
+   if( idle && (ms0 == 0 || ms0 > ms || (ms-ms0)>500) ){      
        ms0 = ms;
        if( mode == 0 ){
           uint32_t tm1 = tm + (millis()/1000);
           int h = (tm1/3600)%24;
           int m = (tm1/60)%60;
-          if( flag )lc.printAnimation(0,h/10,h%10,m/10,m%10,colon,DC_ORANGE,50);
+          if( flag )lc.startPrintAnimation(0,h/10,h%10,m/10,m%10,colon,DC_ORANGE,50);
           else lc.print(0,h/10,h%10,m/10,m%10,colon,DC_ORANGE);
           flag = false;
           colon = !colon;
@@ -43,17 +45,15 @@ void loop() {
      switch( mode ){
          case 0   : 
             mode = 1; 
-            lc.clearAnimation(0,50);
-            lc.printAnimation(0,temp[0],temp[1],temp[2],temp[3],false,DC_RED,50); 
+            lc.startPrintAnimation(0,temp[0],temp[1],temp[2],temp[3],false,DC_RED,50,true); 
             break;
          case 1   : 
             mode = 2; 
-            lc.clearAnimation(0,50);
-            lc.printAnimation(0,hum[0],hum[1],hum[2],hum[3],false,DC_GREEN,50); 
+            lc.startPrintAnimation(0,hum[0],hum[1],hum[2],hum[3],false,DC_GREEN,50,true); 
             break;
          default   : 
             mode = 0; 
-            lc.clearAnimation(0,50);
+            lc.startClearAnimation(0,50);
             flag = true; 
             break;
      }
@@ -0,0 +1,29 @@
+/**
+ * LedControlDC library is developed on the basis of 
+ * LedControl for working with dual color seven segment indicators
+ * 
+ * Fast bit-banged output: the pins are template parameters, so the
+ * display is written straight through the port registers. Everything
+ * else works like with LedControlDC.
+ */
+#include <LedControlFast.h>
+LedControlDCFast<12,11,10> lc;//DataIn, CLK, Load 
+
+void setup() {
+  lc.shutdown(0,false);
+  lc.setIntensity(0,15);
+  lc.clearDisplay(0);
+}
+
+long counter = 0;
+uint32_t ms0 = 0;
+
+void loop() { 
+// A counter of hundredths of a second
+  uint32_t ms = millis();
+  if( ms - ms0 < 10 )return;
+  ms0 = ms;
+// Red and green change every second
+  lc.printNumber(counter,2,(counter/100) % 2 ? DC_GREEN : DC_RED);
+  if( ++counter > 9999 )counter = 0;
+}
@@ -0,0 +1,83 @@
+/**
+ * LedControlDC library is developed on the basis of 
+ * LedControl for working with dual color seven segment indicators
+ * 
+ * User defined font: capital cyrillic letters (cp1251 codes 0xC0..0xDF)
+ * and the degree sign (0xB0) added in front of the built-in font
+ */
+#include <LedControlDC.h>
+LedControlDC lc=LedControlDC(12,11,10);//DataIn, CLK, Load 
+
+// Знакогенератор А..Я, letters that can not be shown are blank
+const uint8_t cyrillicArray[] PROGMEM = {
+//  ABCDEFG  Segments    
+  0b11101110, // 0xC0 'А'
+  0b10111110, // 0xC1 'Б'
+  0b11111110, // 0xC2 'В'
+  0b10001100, // 0xC3 'Г'
+  0b00000000, // 0xC4 'Д'  NO DISPLAY
+  0b10011110, // 0xC5 'Е'
+  0b00000000, // 0xC6 'Ж'  NO DISPLAY
+  0b11110010, // 0xC7 'З'
+  0b01111100, // 0xC8 'И'
+  0b01111100, // 0xC9 'Й'
+  0b00000000, // 0xCA 'К'  NO DISPLAY
+  0b11101100, // 0xCB 'Л'
+  0b00000000, // 0xCC 'М'  NO DISPLAY
+  0b01101110, // 0xCD 'Н'
+  0b11111100, // 0xCE 'О'
+  0b11101100, // 0xCF 'П'
+  0b11001110, // 0xD0 'Р'
+  0b10011100, // 0xD1 'С'
+  0b00011110, // 0xD2 'Т'
+  0b01110110, // 0xD3 'У'
+  0b00000000, // 0xD4 'Ф'  NO DISPLAY
+  0b01101110, // 0xD5 'Х'
+  0b00000000, // 0xD6 'Ц'  NO DISPLAY
+  0b01100110, // 0xD7 'Ч'
+  0b00000000, // 0xD8 'Ш'  NO DISPLAY
+  0b00000000, // 0xD9 'Щ'  NO DISPLAY
+  0b00000000, // 0xDA 'Ъ'  NO DISPLAY
+  0b00000000, // 0xDB 'Ы'  NO DISPLAY
+  0b00111110, // 0xDC 'Ь'
+  0b11110010, // 0xDD 'Э'
+  0b00000000, // 0xDE 'Ю'  NO DISPLAY
+  0b11100110, // 0xDF 'Я'
+};
+
+const uint8_t degreeArray[] PROGMEM = {
+  0b11000110, // 0xB0 '°'
+};
+
+// Fonts are chained: cyrillic, then the degree sign, then the built-in font.
+// A code found in no font is shown as '-'
+const DCFont degreeFont   = { degreeArray, 0xB0, 1, 0b00000010, &DC_FONT_DEFAULT };
+const DCFont cyrillicFont = { cyrillicArray, 0xC0, 32, 0b00000010, &degreeFont };
+
+void setup() {
+  lc.shutdown(0,false);
+  lc.setIntensity(0,15);
+  lc.clearDisplay(0);
+  lc.setFont(cyrillicFont);
+}
+
+uint32_t ms0 = 0;
+int mode = 0;
+
+void loop() { 
+  uint32_t ms = millis();
+  if( !lc.update(ms) )return;
+// Scrolling has ended or 3 seconds of temperature are over
+  if( mode == 0 ){
+// "ПРИВЕТ" in cp1251
+    lc.startScroll("\xCF\xD0\xC8\xC2\xC5\xD2",DC_GREEN,300,false);
+    mode = 1;
+  }
+  else if( mode == 1 ){
+// "-23°"
+    lc.print("-23\xB0",DC_RED);
+    ms0 = ms;
+    mode = 2;
+  }
+  else if( ms - ms0 > 3000 )mode = 0;
+}
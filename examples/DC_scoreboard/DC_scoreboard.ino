@@ -0,0 +1,35 @@
+/**
+ * LedControlDC library is developed on the basis of 
+ * LedControl for working with dual color seven segment indicators
+ * 
+ * Scoreboard of 16 modules (64 digits) on 4 chains of 4 modules.
+ * The chains share DataIn and CLK, each has its own Load pin.
+ * LedControlDCT<16> keeps RAM for exactly 16 modules.
+ */
+#include <LedControlDC.h>
+LedBitBangTransport chain0(12,11,10);//DataIn, CLK, Load
+LedBitBangTransport chain1(12,11,9);
+LedBitBangTransport chain2(12,11,8);
+LedBitBangTransport chain3(12,11,7);
+LedTransport *const chains[] = { &chain0, &chain1, &chain2, &chain3 };
+LedGroupTransport group(chains,4,4);
+LedControlDCT<16> lc(group);
+
+void setup() {
+  lc.shutdownAll(false);
+  lc.setIntensityAll(8);
+  lc.clearAll();
+}
+
+int home  = 0;
+int guest = 0;
+
+void loop() { 
+  char text[48];
+// The whole board is one print: every changed row is one transfer per chain
+  sprintf(text,"#GHOME #R%3d  #GGUEST #R%3d",home,guest);
+  lc.printMarkup(text);
+  if( home <= guest )home += 2;
+  else guest += 3;
+  delay(1000);
+}
@@ -0,0 +1,33 @@
+/**
+ * LedControlDC library is developed on the basis of 
+ * LedControl for working with dual color seven segment indicators
+ * 
+ * Frame streams: a boot screen, an attract loop and an error code 
+ * replayed from flash, no font or animation work at runtime.
+ * streams.h is made on a PC by "ledstream streams.h" (extras/host)
+ */
+#include <LedControlDC.h>
+#include "streams.h"
+LedControlDC lc=LedControlDC(12,11,10);//DataIn, CLK, Load 
+
+void setup() {
+  lc.shutdown(0,false);
+  lc.setIntensity(0,8);
+  lc.clearDisplay(0);
+  lc.play(bootStream);
+}
+
+bool error = false;
+
+void loop() { 
+  uint32_t ms = millis();
+  lc.update(ms);
+// After the boot screen the attract loop, it repeats by itself
+  if( !lc.isPlaying() )lc.play(attractStream);
+// An error after 15 s, the streams start from a dark display
+  if( !error && ms >= 15000 ){
+    error = true;
+    lc.clearDisplay(0);
+    lc.play(errorStream);
+  }
+}
@@ -0,0 +1,75 @@
+// Frame streams for one device, made by extras/host ledstream
+
+// 287 bytes
+const byte bootStream[] PROGMEM = {
+  0x01,0x01,0x00,0xFF,0x81,0x3C,0x00,0x02,0x01,0x00,0xFF,0x06,
+  0x01,0x00,0xFF,0x81,0x3C,0x00,0x07,0x01,0x00,0xFF,0x81,0x3C,
+  0x00,0x03,0x01,0x00,0xFF,0x05,0x01,0x00,0xFF,0x81,0x3C,0x00,
+  0x04,0x01,0x00,0xFF,0x08,0x01,0x00,0x33,0x81,0x30,0x02,0x01,
+  0x01,0x00,0xF7,0x02,0x01,0x00,0x77,0x03,0x01,0x00,0x77,0x04,
+  0x01,0x00,0xF7,0x05,0x01,0x00,0xF7,0x06,0x01,0x00,0xF7,0x07,
+  0x01,0x00,0x77,0x08,0x01,0x00,0x66,0x81,0x50,0x00,0x01,0x01,
+  0x00,0xE7,0x02,0x01,0x00,0xE6,0x03,0x01,0x00,0xE6,0x04,0x01,
+  0x00,0x67,0x05,0x01,0x00,0xE7,0x06,0x01,0x00,0xE7,0x07,0x01,
+  0x00,0xE6,0x08,0x01,0x00,0x44,0x81,0x50,0x00,0x01,0x01,0x00,
+  0xC7,0x02,0x01,0x00,0x45,0x03,0x01,0x00,0x45,0x04,0x01,0x00,
+  0x46,0x05,0x01,0x00,0xC7,0x06,0x01,0x00,0xC7,0x07,0x01,0x00,
+  0xC5,0x08,0x01,0x00,0x00,0x81,0x50,0x00,0x01,0x01,0x00,0x87,
+  0x02,0x01,0x00,0x02,0x03,0x01,0x00,0x02,0x04,0x01,0x00,0x84,
+  0x05,0x01,0x00,0x87,0x06,0x01,0x00,0x87,0x07,0x01,0x00,0x83,
+  0x81,0x38,0x04,0x05,0x01,0x00,0x83,0x06,0x01,0x00,0x83,0x81,
+  0x3C,0x00,0x01,0x01,0x00,0x83,0x04,0x01,0x00,0x80,0x81,0x78,
+  0x00,0x05,0x01,0x00,0x81,0x06,0x01,0x00,0x81,0x81,0x3C,0x00,
+  0x01,0x01,0x00,0x81,0x07,0x01,0x00,0x81,0x81,0x3C,0x00,0x02,
+  0x01,0x00,0x00,0x03,0x01,0x00,0x00,0x81,0x3C,0x00,0x05,0x01,
+  0x00,0x80,0x06,0x01,0x00,0x80,0x81,0x3C,0x00,0x01,0x01,0x00,
+  0x80,0x07,0x01,0x00,0x80,0x81,0x78,0x00,0x05,0x01,0x00,0x00,
+  0x06,0x01,0x00,0x00,0x81,0x3C,0x00,0x01,0x01,0x00,0x00,0x04,
+  0x01,0x00,0x00,0x07,0x01,0x00,0x00,0x81,0x78,0x00,0x80
+};
+
+// 63 bytes
+const byte errorStream[] PROGMEM = {
+  0x01,0x01,0x00,0xC8,0x02,0x01,0x00,0x99,0x03,0x01,0x00,0x11,
+  0x04,0x01,0x00,0xC8,0x05,0x01,0x00,0xC8,0x06,0x01,0x00,0x51,
+  0x07,0x01,0x00,0xD9,0x81,0xFA,0x00,0x01,0x01,0x00,0x40,0x02,
+  0x01,0x00,0x00,0x03,0x01,0x00,0x00,0x04,0x01,0x00,0x40,0x05,
+  0x01,0x00,0x40,0x06,0x01,0x00,0x40,0x07,0x01,0x00,0x40,0x81,
+  0xF9,0x00,0x82
+};
+
+// 374 bytes
+const byte attractStream[] PROGMEM = {
+  0x01,0x01,0x00,0x87,0x02,0x01,0x00,0x87,0x03,0x01,0x00,0x87,
+  0x04,0x01,0x00,0x87,0x05,0x01,0x00,0x87,0x06,0x01,0x00,0x87,
+  0x81,0xA4,0x01,0x02,0x01,0x00,0xFF,0x03,0x01,0x00,0xFF,0x81,
+  0x50,0x00,0x01,0x01,0x00,0x00,0x04,0x01,0x00,0x00,0x05,0x01,
+  0x00,0x00,0x06,0x01,0x00,0x00,0x81,0x54,0x01,0x01,0x01,0x00,
+  0x78,0x04,0x01,0x00,0x78,0x05,0x01,0x00,0x78,0x07,0x01,0x00,
+  0x78,0x81,0x50,0x00,0x02,0x01,0x00,0x78,0x03,0x01,0x00,0x00,
+  0x81,0x54,0x01,0x01,0x01,0x00,0xFF,0x02,0x01,0x00,0xFF,0x03,
+  0x01,0x00,0x87,0x04,0x01,0x00,0xFF,0x07,0x01,0x00,0xFF,0x81,
+  0x50,0x00,0x01,0x01,0x00,0x87,0x02,0x01,0x00,0x87,0x04,0x01,
+  0x00,0x87,0x05,0x01,0x00,0x00,0x07,0x01,0x00,0x87,0x81,0x54,
+  0x01,0x02,0x01,0x00,0xFF,0x03,0x01,0x00,0xFF,0x06,0x01,0x00,
+  0xFF,0x07,0x01,0x00,0xFF,0x81,0x50,0x00,0x01,0x01,0x00,0x00,
+  0x04,0x01,0x00,0x00,0x81,0x54,0x01,0x01,0x01,0x00,0x78,0x04,
+  0x01,0x00,0x78,0x81,0x50,0x00,0x02,0x01,0x00,0x00,0x03,0x01,
+  0x00,0x78,0x06,0x01,0x00,0x78,0x07,0x01,0x00,0x78,0x81,0x54,
+  0x01,0x01,0x01,0x00,0xFF,0x03,0x01,0x00,0xFF,0x04,0x01,0x00,
+  0xFF,0x05,0x01,0x00,0x87,0x06,0x01,0x00,0xFF,0x07,0x01,0x00,
+  0xFF,0x81,0x50,0x00,0x01,0x01,0x00,0x87,0x03,0x01,0x00,0x87,
+  0x04,0x01,0x00,0x87,0x06,0x01,0x00,0x87,0x07,0x01,0x00,0x87,
+  0x81,0x54,0x01,0x01,0x01,0x00,0xFF,0x02,0x01,0x00,0xFF,0x03,
+  0x01,0x00,0xFF,0x81,0x50,0x00,0x04,0x01,0x00,0x00,0x05,0x01,
+  0x00,0x00,0x06,0x01,0x00,0x00,0x07,0x01,0x00,0x00,0x81,0x54,
+  0x01,0x04,0x01,0x00,0x78,0x05,0x01,0x00,0x78,0x06,0x01,0x00,
+  0x78,0x07,0x01,0x00,0x78,0x81,0x50,0x00,0x01,0x01,0x00,0x78,
+  0x02,0x01,0x00,0x78,0x03,0x01,0x00,0x78,0x81,0x54,0x01,0x01,
+  0x01,0x00,0xFF,0x02,0x01,0x00,0xFF,0x03,0x01,0x00,0xFF,0x04,
+  0x01,0x00,0xFF,0x06,0x01,0x00,0xFF,0x07,0x01,0x00,0xFF,0x81,
+  0x50,0x00,0x01,0x01,0x00,0x87,0x02,0x01,0x00,0x87,0x03,0x01,
+  0x00,0x87,0x04,0x01,0x00,0x87,0x05,0x01,0x00,0x00,0x06,0x01,
+  0x00,0x87,0x07,0x01,0x00,0x87,0x81,0x54,0x01,0x07,0x01,0x00,
+  0x00,0x82
+};
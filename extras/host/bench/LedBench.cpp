@@ -0,0 +1,344 @@
+/*
+ * LedBench.cpp - Bus cost of the public LedControl/LedControlDC calls
+ *
+ * Every call is run once on a freshly initialized chain of 1 to 8 devices
+ * connected to the simulator. The frames (LOAD/CS pulses), clock edges
+ * and bytes it puts on the bus, and the register writes the library
+ * left out (LedStats), are written as a CSV table, to stdout or to the
+ * file given as first argument.
+ *
+ * After each call the rows of the simulated chain are checked against
+ * the rows the library keeps, once the queued writes are sent. A call
+ * that leaves them different is reported on stderr and makes the bench
+ * return 1.
+ *
+ *   ledbench [file.csv]
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "LedControlDC.h"
+#include "Max7219Sim.h"
+
+#define DATA_PIN 12
+#define CLK_PIN  11
+#define CS_PIN   10
+
+/* Prepare the display before the measured call, not counted */
+typedef void (*BenchSetup)(LedControlDC &lc);
+/* The measured call */
+typedef void (*BenchCall)(LedControlDC &lc);
+
+struct Bench {
+    const char *name;
+    BenchSetup setup;
+    BenchCall call;
+};
+
+static void setupNone(LedControlDC &lc) {
+    (void)lc;
+}
+
+static void setupPrint(LedControlDC &lc) {
+    lc.print(0,'1','2','3','4',true,DC_ORANGE);
+}
+
+static void setupFull(LedControlDC &lc) {
+    for(int i=0;i<lc.getDeviceCount();i++) {
+        for(int row=0;row<8;row++)
+            lc.setRow(i,row,0xFF);
+    }
+}
+
+static void setupScroll(LedControlDC &lc) {
+    lc.startScroll("HELLO 12.34 HELLO 12.34 HELLO 12.34",DC_ORANGE,100);
+    for(int i=0;i<lc.getDigitCount();i++)
+        lc.update(i*100);
+}
+
+static void setupColors(LedControlDC &lc) {
+    static const DC_COLOR colors[4]={DC_RED,DC_RED,DC_GREEN,DC_ORANGE};
+    for(int i=0;i<lc.getDeviceCount();i++)
+        lc.printColors(i,'1','2','3','4',true,colors);
+}
+
+static void setupBlink(LedControlDC &lc) {
+    setupColors(lc);
+    for(int i=0;i<lc.getDeviceCount();i++)
+        lc.blink(i,0x03,500);
+    // starts the timer, the measured update switches the digits off
+    lc.update(0);
+}
+
+static void setupBlend(LedControlDC &lc) {
+    lc.print("8888888888888888888888888888888",DC_ORANGE);
+    for(int i=0;i<lc.getDeviceCount();i++)
+        lc.setBlend(i,8);
+    // 8/16 is green, red, green... the measured tick switches to red
+    lc.tick();
+}
+
+static void setupFade(LedControlDC &lc) {
+    lc.setIntensityAll(15);
+    lc.fadeAllTo(0,1000);
+    lc.update(0);
+}
+
+static LedQueueOp queue[80];
+
+static void setupQueue(LedControlDC &lc) {
+    lc.setQueue(queue,80);
+}
+
+static void setupQueuedText(LedControlDC &lc) {
+    lc.setQueue(queue,80);
+    lc.print("12.345678901234567890123456789012",DC_ORANGE);
+}
+
+static void setupRegisters(LedControlDC &lc) {
+    lc.shutdownAll(false);
+    lc.setIntensityAll(8);
+    lc.setRow(lc.getDeviceCount()-1,3,B01010101);
+}
+
+static void setupResync(LedControlDC &lc) {
+    setupRegisters(lc);
+    lc.print("12.345678901234567890123456789012",DC_ORANGE);
+    lc.resync();
+}
+
+static void callSetLed(LedControlDC &lc) {
+    lc.setLed(lc.getDeviceCount()-1,3,4,true);
+}
+
+static void callSetRow(LedControlDC &lc) {
+    lc.setRow(lc.getDeviceCount()-1,3,B01010101);
+}
+
+static void callSetColumn(LedControlDC &lc) {
+    lc.setColumn(lc.getDeviceCount()-1,4,B11111111);
+}
+
+static void callSetDigit(LedControlDC &lc) {
+    lc.LedControl::setDigit(lc.getDeviceCount()-1,3,8,true);
+}
+
+static void callSetChar(LedControlDC &lc) {
+    lc.LedControl::setChar(lc.getDeviceCount()-1,3,'H',true);
+}
+
+static void callSetCharDC(LedControlDC &lc) {
+    lc.setCharDC(0,1,'8',true,'8',true);
+}
+
+static void callPrint(LedControlDC &lc) {
+    lc.print(0,'1','2','3','4',true,DC_ORANGE);
+}
+
+static void callPrintOther(LedControlDC &lc) {
+    lc.print(0,'5','6','7','8',false,DC_GREEN);
+}
+
+static void callBlendTick(LedControlDC &lc) {
+    lc.tick();
+}
+
+static void callFadeStep(LedControlDC &lc) {
+    lc.update(500);
+}
+
+static void callServiceAll(LedControlDC &lc) {
+    while(!lc.service());
+}
+
+static void callRepeatRegisters(LedControlDC &lc) {
+    lc.shutdownAll(false);
+    lc.setIntensityAll(8);
+    lc.setIntensity(0,8);
+}
+
+static void callResync(LedControlDC &lc) {
+    while(!lc.updateResync(0));
+}
+
+static void callClearDisplay(LedControlDC &lc) {
+    lc.clearDisplay(lc.getDeviceCount()-1);
+}
+
+static void callClearAll(LedControlDC &lc) {
+    lc.clearAll();
+}
+
+static void callSwapText(LedControlDC &lc) {
+    lc.swap();
+    lc.print("12345678901234567890123456789012",DC_ORANGE);
+    lc.swap();
+}
+
+static void callSwapReverted(LedControlDC &lc) {
+    lc.swap();
+    lc.print(0,'5','6','7','8',false,DC_GREEN);
+    lc.print(0,'1','2','3','4',true,DC_ORANGE);
+    lc.swap();
+}
+
+/* Row 0 and 1 of all 8 devices, two frame records */
+static const byte benchStream[] PROGMEM = {
+    0x01,8, 0,0x7E, 1,0x30, 2,0x6D, 3,0x79, 4,0x33, 5,0x5B, 6,0x5F, 7,0x70,
+    0x02,8, 0,0x01, 1,0x01, 2,0x01, 3,0x01, 4,0x01, 5,0x01, 6,0x01, 7,0x01,
+    LED_STREAM_END
+};
+
+static void callPlayStream(LedControlDC &lc) {
+    lc.play(benchStream);
+    lc.update(0);
+}
+
+static void callClear(LedControlDC &lc) {
+    lc.clear();
+}
+
+static void callFill(LedControlDC &lc) {
+    lc.fill(DC_GREEN);
+}
+
+static void callInvert(LedControlDC &lc) {
+    lc.invert();
+}
+
+static void callSwapColors(LedControlDC &lc) {
+    lc.swapColors();
+}
+
+static void callBlinkStep(LedControlDC &lc) {
+    lc.update(500);
+}
+
+static void callPrintEach(LedControlDC &lc) {
+    for(int i=0;i<lc.getDeviceCount();i++)
+        lc.print(i,'1','2','3','4',true,DC_ORANGE);
+}
+
+static void callPrintEachBuffered(LedControlDC &lc) {
+    lc.setBuffered(true);
+    for(int i=0;i<lc.getDeviceCount();i++)
+        lc.print(i,'1','2','3','4',true,DC_ORANGE);
+    lc.commit();
+}
+
+static void callPrintText(LedControlDC &lc) {
+    lc.print("12.345678901234567890123456789012",DC_ORANGE);
+}
+
+static void callPrintColors(LedControlDC &lc) {
+    static const DC_COLOR colors[4] = { DC_RED, DC_GREEN, DC_ORANGE, DC_RED };
+    lc.printColors(0,'1','2','3','4',false,colors);
+}
+
+static void callPrintMarkup(LedControlDC &lc) {
+    lc.printMarkup("#R12.34#G5678#O9012#R3456#G7890#O1234#R5678#G9012");
+}
+
+static void callScrollStep(LedControlDC &lc) {
+    lc.update(lc.getDigitCount()*100);
+}
+
+static void callPrintAnimation(LedControlDC &lc) {
+    lc.printAnimation(0,'1','2','3','4',true,DC_ORANGE,0);
+}
+
+static void callClearAnimation(LedControlDC &lc) {
+    lc.clearAnimation(0,0);
+}
+
+static void callBufferedPrint(LedControlDC &lc) {
+    lc.setBuffered(true);
+    lc.print(0,'5','6','7','8',false,DC_GREEN);
+    lc.commit();
+}
+
+static const Bench benches[] = {
+    { "setLed",          setupNone,  callSetLed },
+    { "setRow",          setupNone,  callSetRow },
+    { "setColumn",       setupNone,  callSetColumn },
+    { "setDigit",        setupNone,  callSetDigit },
+    { "setChar",         setupNone,  callSetChar },
+    { "setCharDC",       setupNone,  callSetCharDC },
+    { "print",           setupNone,  callPrint },
+    { "print_unchanged", setupPrint, callPrint },
+    { "print_changed",   setupPrint, callPrintOther },
+    { "print_buffered",  setupPrint, callBufferedPrint },
+    { "print_each",      setupNone,  callPrintEach },
+    { "print_each_buffered", setupNone, callPrintEachBuffered },
+    { "setRow_unchanged", setupRegisters, callSetRow },
+    { "registers_unchanged", setupRegisters, callRepeatRegisters },
+    { "resync",          setupResync, callResync },
+    { "print_text",      setupNone,  callPrintText },
+    { "print_colors",    setupNone,  callPrintColors },
+    { "print_markup",    setupNone,  callPrintMarkup },
+    { "print_text_queued", setupQueue, callPrintText },
+    { "queue_service",   setupQueuedText, callServiceAll },
+    { "scroll_step",     setupScroll, callScrollStep },
+    { "blend_tick",      setupBlend, callBlendTick },
+    { "fade_step",       setupFade,  callFadeStep },
+    { "clearDisplay",    setupFull,  callClearDisplay },
+    { "clearAll",        setupFull,  callClearAll },
+    { "swap_text",       setupNone,  callSwapText },
+    { "swap_reverted",   setupPrint, callSwapReverted },
+    { "play_stream",     setupNone,  callPlayStream },
+    { "clear",           setupColors, callClear },
+    { "fill",            setupColors, callFill },
+    { "invert",          setupColors, callInvert },
+    { "swapColors",      setupColors, callSwapColors },
+    { "blink_step",      setupBlink, callBlinkStep },
+    { "printAnimation",  setupNone,  callPrintAnimation },
+    { "clearAnimation",  setupPrint, callClearAnimation },
+};
+
+/* The chain has to show what the library thinks it shows */
+static bool chainEqual(LedControlDC &lc, Max7219Sim &sim) {
+    for(int i=0;i<lc.getDeviceCount();i++) {
+        for(int row=0;row<8;row++) {
+            if(sim.getRow(i,row)!=lc.getRow(i,row))
+                return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    FILE *out=stdout;
+    int result=0;
+
+    if(argc>1) {
+        out=fopen(argv[1],"w");
+        if(!out) {
+            perror(argv[1]);
+            return 1;
+        }
+    }
+    fprintf(out,"call,devices,frames,clocks,bytes,elided\n");
+    for(unsigned int b=0;b<sizeof(benches)/sizeof(benches[0]);b++) {
+        for(int devices=1;devices<=8;devices++) {
+            hostSetMicros(0);
+            Max7219Sim sim(DATA_PIN,CLK_PIN,CS_PIN,devices);
+            LedControlDC lc(DATA_PIN,CLK_PIN,CS_PIN,devices);
+            benches[b].setup(lc);
+            sim.resetCounters();
+            lc.resetStats();
+            benches[b].call(lc);
+            fprintf(out,"%s,%d,%lu,%lu,%lu,%lu\n",benches[b].name,devices,
+                sim.getFrameCount(),sim.getClockCount(),sim.getByteCount(),
+                lc.getStats().elided);
+            while(!lc.service());
+            if(!chainEqual(lc,sim)) {
+                fprintf(stderr,"%s, %d devices: the chain does not show the rows\n",
+                    benches[b].name,devices);
+                result=1;
+            }
+        }
+    }
+    if(out!=stdout)
+        fclose(out);
+    return result;
+}
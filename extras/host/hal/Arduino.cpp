@@ -0,0 +1,115 @@
+/*
+ * Arduino.cpp - Minimal Arduino core for building LedControlDC on a host
+ */
+
+#include "Arduino.h"
+
+#define HOST_MAX_HOOKS 8
+
+static uint8_t pinLevel[HOST_PIN_COUNT];
+static unsigned long nowMicros=0;
+static HostPinHook hooks[HOST_MAX_HOOKS];
+static void *hookContext[HOST_MAX_HOOKS];
+static HostDelayHook delayHook=NULL;
+static void *delayContext=NULL;
+static bool interruptsOn=true;
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    (void)pin;
+    (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    if(pin>=HOST_PIN_COUNT)
+        return;
+    val=val ? HIGH : LOW;
+    pinLevel[pin]=val;
+    for(int i=0;i<HOST_MAX_HOOKS;i++) {
+        if(hooks[i])
+            hooks[i](hookContext[i],pin,val);
+    }
+}
+
+int digitalRead(uint8_t pin) {
+    if(pin>=HOST_PIN_COUNT)
+        return LOW;
+    return pinLevel[pin];
+}
+
+void shiftOut(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t val) {
+    //the same as wiring_shift.c of the AVR core
+    for(uint8_t i=0;i<8;i++) {
+        if(bitOrder==LSBFIRST)
+            digitalWrite(dataPin,!!(val & (1 << i)));
+        else
+            digitalWrite(dataPin,!!(val & (1 << (7-i))));
+        digitalWrite(clockPin,HIGH);
+        digitalWrite(clockPin,LOW);
+    }
+}
+
+void delay(unsigned long ms) {
+    nowMicros+=ms*1000;
+    if(delayHook)
+        delayHook(delayContext,ms);
+}
+
+void delayMicroseconds(unsigned int us) {
+    nowMicros+=us;
+}
+
+unsigned long millis() {
+    //reading the clock takes time, so loops waiting for it do end
+    nowMicros+=HOST_CLOCK_READ_MICROS;
+    return nowMicros/1000;
+}
+
+unsigned long micros() {
+    nowMicros+=HOST_CLOCK_READ_MICROS;
+    return nowMicros;
+}
+
+void noInterrupts() {
+    interruptsOn=false;
+}
+
+void interrupts() {
+    interruptsOn=true;
+}
+
+bool hostAddPinHook(HostPinHook hook, void *context) {
+    for(int i=0;i<HOST_MAX_HOOKS;i++) {
+        if(!hooks[i]) {
+            hooks[i]=hook;
+            hookContext[i]=context;
+            return true;
+        }
+    }
+    return false;
+}
+
+void hostRemovePinHook(HostPinHook hook, void *context) {
+    for(int i=0;i<HOST_MAX_HOOKS;i++) {
+        if(hooks[i]==hook && hookContext[i]==context) {
+            hooks[i]=NULL;
+            hookContext[i]=NULL;
+        }
+    }
+}
+
+void hostSetDelayHook(HostDelayHook hook, void *context) {
+    delayHook=hook;
+    delayContext=context;
+}
+
+void hostAdvanceMicros(unsigned long us) {
+    nowMicros+=us;
+}
+
+void hostSetMicros(unsigned long us) {
+    nowMicros=us;
+}
+
+bool hostInterruptsEnabled() {
+    return interruptsOn;
+}
@@ -0,0 +1,107 @@
+/*
+ * Arduino.h - Minimal Arduino core for building LedControlDC on a host
+ *
+ * Only what the library and its examples use is provided. Time is 
+ * simulated: delay() advances the clock instead of waiting, millis() and
+ * micros() read it and advance it a little, like the real call would, so
+ * loops waiting for the time end. Every pin write is reported to the 
+ * registered pin hooks, this is how the MAX7219 simulator sees the bus.
+ */
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "binary.h"
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef uint16_t word;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT  0x0
+#define OUTPUT 0x1
+
+#define LSBFIRST 0
+#define MSBFIRST 1
+
+/* The hardware SPI pins of an Arduino Uno */
+static const uint8_t SS   = 10;
+static const uint8_t MOSI = 11;
+static const uint8_t MISO = 12;
+static const uint8_t SCK  = 13;
+
+/* Number of simulated pins */
+#define HOST_PIN_COUNT 64
+
+/* Each call of millis() or micros() advances the simulated clock this much */
+#define HOST_CLOCK_READ_MICROS 4
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+void shiftOut(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t val);
+
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+unsigned long millis();
+unsigned long micros();
+
+void noInterrupts();
+void interrupts();
+
+/*
+ * Called for every digitalWrite() on a pin, with the new level.
+ */
+typedef void (*HostPinHook)(void *context, uint8_t pin, uint8_t val);
+
+/*
+ * Register a pin hook, at most 8 hooks can be registered.
+ * Returns :
+ * bool	true if the hook was registered
+ */
+bool hostAddPinHook(HostPinHook hook, void *context);
+
+/*
+ * Remove a pin hook registered before with the same context.
+ */
+void hostRemovePinHook(HostPinHook hook, void *context);
+
+/*
+ * Called for every delay(), after the clock was advanced.
+ */
+typedef void (*HostDelayHook)(void *context, unsigned long ms);
+
+/*
+ * Set the delay hook, NULL removes it. There is only one.
+ */
+void hostSetDelayHook(HostDelayHook hook, void *context);
+
+/*
+ * Advance the simulated clock.
+ * Params :
+ * us	microseconds to add
+ */
+void hostAdvanceMicros(unsigned long us);
+
+/*
+ * Set the simulated clock, e.g. back to 0 between runs.
+ * Params :
+ * us	the new time in microseconds
+ */
+void hostSetMicros(unsigned long us);
+
+/*
+ * Tells if interrupts are on, noInterrupts() and interrupts() switch 
+ * them although there are none on the host.
+ * Returns :
+ * bool	false between noInterrupts() and interrupts()
+ */
+bool hostInterruptsEnabled();
+
+#endif	//Arduino.h
@@ -0,0 +1,7 @@
+/*
+ * SPI.cpp - Hardware SPI for host builds
+ */
+
+#include "SPI.h"
+
+SPIClass SPI;
@@ -0,0 +1,57 @@
+/*
+ * SPI.h - Hardware SPI for host builds
+ *
+ * The bytes are clocked out on the MOSI and SCK pins of an Arduino Uno
+ * with digitalWrite(), in SPI mode 0, so the MAX7219 simulator can 
+ * decode them like any other transport.
+ */
+
+#ifndef SPI_h
+#define SPI_h
+
+#include "Arduino.h"
+
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x04
+#define SPI_MODE2 0x08
+#define SPI_MODE3 0x0C
+
+class SPISettings {
+    public:
+        SPISettings(uint32_t clock=4000000, uint8_t bitOrder=MSBFIRST, uint8_t dataMode=SPI_MODE0) {
+            this->clock=clock;
+            this->bitOrder=bitOrder;
+            this->dataMode=dataMode;
+        }
+        uint32_t clock;
+        uint8_t bitOrder;
+        uint8_t dataMode;
+};
+
+class SPIClass {
+    private :
+        uint8_t bitOrder;
+
+    public:
+        void begin() {
+            bitOrder=MSBFIRST;
+            pinMode(MOSI,OUTPUT);
+            pinMode(SCK,OUTPUT);
+            digitalWrite(SCK,LOW);
+        }
+        void end() {
+        }
+        void beginTransaction(SPISettings settings) {
+            bitOrder=settings.bitOrder;
+        }
+        void endTransaction() {
+        }
+        uint8_t transfer(uint8_t data) {
+            shiftOut(MOSI,SCK,bitOrder,data);
+            return 0;
+        }
+};
+
+extern SPIClass SPI;
+
+#endif	//SPI.h
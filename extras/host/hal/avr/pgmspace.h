@@ -0,0 +1,29 @@
+/*
+ * pgmspace.h - Program memory access for host builds
+ *
+ * On the host there is only one address space, PROGMEM data is
+ * ordinary const data and the pgm_read functions are plain reads.
+ */
+
+#ifndef Pgmspace_h
+#define Pgmspace_h
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(s) (s)
+
+#define pgm_read_byte(addr)  (*(const uint8_t *)(addr))
+#define pgm_read_word(addr)  (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define pgm_read_ptr(addr)   (*(void * const *)(addr))
+
+#define pgm_read_byte_near(addr) pgm_read_byte(addr)
+#define pgm_read_word_near(addr) pgm_read_word(addr)
+
+#define memcpy_P memcpy
+#define strlen_P strlen
+
+#endif	//pgmspace.h
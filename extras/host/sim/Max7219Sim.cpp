@@ -0,0 +1,145 @@
+/*
+ * Max7219Sim.cpp - Bit accurate simulation of a cascade of MAX7219/MAX7221
+ */
+
+#include "Max7219Sim.h"
+
+//the registers of the MAX7221 and MAX7219
+#define OP_NOOP   0
+#define OP_DECODEMODE  9
+#define OP_INTENSITY   10
+#define OP_SCANLIMIT   11
+#define OP_SHUTDOWN    12
+#define OP_DISPLAYTEST 15
+
+Max7219Sim::Max7219Sim(int dataPin, int clkPin, int csPin, int numDevices) {
+    this->dataPin=dataPin;
+    this->clkPin=clkPin;
+    this->csPin=csPin;
+    if(numDevices<=0)
+        numDevices=1;
+    this->numDevices=numDevices;
+    shift.assign(numDevices,0);
+    regs.assign(numDevices*16,0);
+    clk=digitalRead(clkPin);
+    cs=digitalRead(csPin);
+    din=digitalRead(dataPin);
+    powerUp();
+    resetCounters();
+    hostAddPinHook(pinHook,this);
+}
+
+Max7219Sim::~Max7219Sim() {
+    hostRemovePinHook(pinHook,this);
+}
+
+void Max7219Sim::powerUp() {
+    for(int i=0;i<numDevices;i++)
+        shift[i]=0;
+    for(int i=0;i<numDevices*16;i++)
+        regs[i]=0;
+}
+
+void Max7219Sim::pinHook(void *context, uint8_t pin, uint8_t val) {
+    ((Max7219Sim *)context)->onPin(pin,val);
+}
+
+void Max7219Sim::onPin(uint8_t pin, uint8_t val) {
+    if(pin==dataPin)
+        din=val;
+    if(pin==clkPin) {
+        //data is shifted in on the rising edge while the chip is loading
+        if(!clk && val && !cs) {
+            uint8_t in=din;
+            for(int i=0;i<numDevices;i++) {
+                uint8_t out=shift[i]>>15;
+                shift[i]=(uint16_t)((shift[i]<<1)|in);
+                in=out;
+            }
+            clocks++;
+            clocksInFrame++;
+        }
+        clk=val;
+    }
+    if(pin==csPin) {
+        if(!cs && val) 
+            latch();
+        if(cs && !val)
+            clocksInFrame=0;
+        cs=val;
+    }
+}
+
+void Max7219Sim::latch() {
+    frames++;
+    if(clocksInFrame!=(unsigned long)numDevices*16)
+        shortFrames++;
+    for(int i=0;i<numDevices;i++) {
+        uint8_t reg=(shift[i]>>8) & 0x0F;
+        if(reg!=OP_NOOP)
+            regs[i*16+reg]=shift[i] & 0xFF;
+    }
+}
+
+int Max7219Sim::getDeviceCount() {
+    return numDevices;
+}
+
+uint8_t Max7219Sim::getRegister(int addr, int reg) {
+    if(addr<0 || addr>=numDevices || reg<0 || reg>15)
+        return 0;
+    return regs[addr*16+reg];
+}
+
+uint8_t Max7219Sim::getRow(int addr, int row) {
+    return getRegister(addr,row+1);
+}
+
+bool Max7219Sim::isShutdown(int addr) {
+    return (getRegister(addr,OP_SHUTDOWN) & 0x01)==0;
+}
+
+uint8_t Max7219Sim::getIntensity(int addr) {
+    return getRegister(addr,OP_INTENSITY) & 0x0F;
+}
+
+uint8_t Max7219Sim::getScanLimit(int addr) {
+    return getRegister(addr,OP_SCANLIMIT) & 0x07;
+}
+
+bool Max7219Sim::isDisplayTest(int addr) {
+    return (getRegister(addr,OP_DISPLAYTEST) & 0x01)!=0;
+}
+
+bool Max7219Sim::rowsEqual(const uint8_t *status) {
+    for(int i=0;i<numDevices;i++) {
+        for(int row=0;row<8;row++) {
+            if(getRow(i,row)!=status[i*8+row])
+                return false;
+        }
+    }
+    return true;
+}
+
+unsigned long Max7219Sim::getFrameCount() {
+    return frames;
+}
+
+unsigned long Max7219Sim::getClockCount() {
+    return clocks;
+}
+
+unsigned long Max7219Sim::getByteCount() {
+    return clocks/8;
+}
+
+unsigned long Max7219Sim::getShortFrameCount() {
+    return shortFrames;
+}
+
+void Max7219Sim::resetCounters() {
+    frames=0;
+    clocks=0;
+    clocksInFrame=0;
+    shortFrames=0;
+}
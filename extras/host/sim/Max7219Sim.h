@@ -0,0 +1,141 @@
+/*
+ * Max7219Sim.h - Bit accurate simulation of a cascade of MAX7219/MAX7221
+ *
+ * The simulator watches the DIN, CLK and LOAD/CS pins through the pin 
+ * hooks of the host Arduino core. Every rising edge of CLK shifts DIN into
+ * the 16 bit shift register of the first device, the bit falling out of a
+ * device goes into the next one. The rising edge of LOAD/CS latches the
+ * shift register of every device into the addressed register, just like 
+ * the chip does.
+ */
+
+#ifndef Max7219Sim_h
+#define Max7219Sim_h
+
+#include <Arduino.h>
+#include <vector>
+
+class Max7219Sim {
+    private :
+        int dataPin;
+        int clkPin;
+        int csPin;
+        int numDevices;
+        /* Level of the pins we watch */
+        uint8_t clk;
+        uint8_t cs;
+        uint8_t din;
+        /* The shift registers, device 0 is the one at the MCU */
+        std::vector<uint16_t> shift;
+        /* The 16 registers of each device */
+        std::vector<uint8_t> regs;
+        /* Counters of the bus activity */
+        unsigned long frames;
+        unsigned long clocks;
+        unsigned long clocksInFrame;
+        unsigned long shortFrames;
+
+        static void pinHook(void *context, uint8_t pin, uint8_t val);
+        void onPin(uint8_t pin, uint8_t val);
+        void latch();
+
+    public:
+        /* 
+         * Create a new simulated chain and attach it to the pins
+         * Params :
+         * dataPin		pin connected to DIN of the first device
+         * clkPin		pin connected to CLK
+         * csPin		pin connected to LOAD/CS
+         * numDevices	number of devices on the chain
+         */
+        Max7219Sim(int dataPin, int clkPin, int csPin, int numDevices=1);
+        ~Max7219Sim();
+
+        /*
+         * Put all devices into their power-up state: display blank, 
+         * shutdown mode on, all registers cleared.
+         */
+        void powerUp();
+
+        /*
+         * Gets the number of devices on the chain.
+         * Returns :
+         * int	the number of devices
+         */
+        int getDeviceCount();
+
+        /*
+         * Gets a register of a device.
+         * Params :
+         * addr	address of the device
+         * reg	the register (opcode) 0..15
+         * Returns :
+         * uint8_t	the value latched last into this register
+         */
+        uint8_t getRegister(int addr, int reg);
+
+        /*
+         * Gets the led-status of a row (digit register 1..8).
+         * Params :
+         * addr	address of the device
+         * row	the row 0..7
+         * Returns :
+         * uint8_t	the value of the row
+         */
+        uint8_t getRow(int addr, int row);
+
+        /*
+         * Tells if a device is in shutdown mode.
+         */
+        bool isShutdown(int addr);
+
+        /*
+         * Gets the intensity register of a device.
+         */
+        uint8_t getIntensity(int addr);
+
+        /*
+         * Gets the scan limit register of a device.
+         */
+        uint8_t getScanLimit(int addr);
+
+        /*
+         * Tells if the display test of a device is on.
+         */
+        bool isDisplayTest(int addr);
+
+        /*
+         * Compare the rows of all devices against a led-status array 
+         * laid out like LedControl::status[].
+         * Returns :
+         * bool	true if every row matches
+         */
+        bool rowsEqual(const uint8_t *status);
+
+        /*
+         * Number of frames (rising edges of LOAD/CS) seen.
+         */
+        unsigned long getFrameCount();
+
+        /*
+         * Number of rising clock edges seen while LOAD/CS was low.
+         */
+        unsigned long getClockCount();
+
+        /*
+         * Number of bytes shifted, the clock edges divided by 8.
+         */
+        unsigned long getByteCount();
+
+        /*
+         * Number of frames that did not carry 16 bits for every device.
+         */
+        unsigned long getShortFrameCount();
+
+        /*
+         * Set all counters to 0, the registers are kept.
+         */
+        void resetCounters();
+};
+
+#endif	//Max7219Sim.h
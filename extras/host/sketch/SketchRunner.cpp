@@ -0,0 +1,68 @@
+/*
+ * SketchRunner.cpp - Run an example sketch against the simulated display
+ *
+ * The sketch given by SKETCH is compiled into this file. setup() and loop()
+ * are called with the simulated clock advancing 1ms per loop, every time 
+ * the display changes its rows are printed together with the red and green
+ * image of each digit of the dual color module.
+ *
+ *   sketch_DC_timer [seconds]
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "Max7219Sim.h"
+
+/* The examples use DataIn 12, CLK 11 and Load 10. It has to be created
+   before the LedControlDC of the sketch to see its setup */
+static Max7219Sim sim(12,11,10,1);
+
+#include SKETCH
+
+/* Columns of the red and green part of each digit on the module */
+static const int redColumn[4]   = {1,2,3,4};
+static const int greenColumn[4] = {5,6,7,0};
+
+static uint8_t columnImage(int col) {
+    uint8_t img=0;
+    for(int row=0;row<8;row++) {
+        if(sim.getRow(0,row) & (B10000000 >> col))
+            img|=B10000000 >> row;
+    }
+    return img;
+}
+
+static void printDisplay() {
+    printf("%8lu ms  rows",millis());
+    for(int row=0;row<8;row++)
+        printf(" %02x",sim.getRow(0,row));
+    printf("  digits");
+    for(int i=0;i<4;i++)
+        printf(" R%02x/G%02x",columnImage(redColumn[i]),columnImage(greenColumn[i]));
+    printf("\n");
+}
+
+int main(int argc, char **argv) {
+    unsigned long seconds=20;
+    uint8_t last[8];
+
+    if(argc>1)
+        seconds=strtoul(argv[1],NULL,10);
+    memset(last,0,sizeof(last));
+    setup();
+    while(millis()<seconds*1000) {
+        loop();
+        bool changed=false;
+        for(int row=0;row<8;row++) {
+            if(sim.getRow(0,row)!=last[row]) {
+                last[row]=sim.getRow(0,row);
+                changed=true;
+            }
+        }
+        if(changed)
+            printDisplay();
+        hostAdvanceMicros(1000);
+    }
+    printf("%lu frames, %lu bytes\n",sim.getFrameCount(),sim.getByteCount());
+    return 0;
+}
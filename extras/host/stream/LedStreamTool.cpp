@@ -0,0 +1,99 @@
+/*
+ * LedStreamTool.cpp - Make the frame streams of the DC_stream example
+ *
+ * Each stream is drawn with the usual print()/animation calls of a 
+ * LedControlDC running on a LedStreamWriter, with the simulated clock
+ * standing in for the time the sketch would take. The streams are 
+ * written as PROGMEM arrays, to stdout or to the file given as first 
+ * argument.
+ *
+ *   ledstream [streams.h]
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include "LedControlDC.h"
+#include "LedStreamWriter.h"
+
+/* Let update() run the animation until it is done, 1 ms per call */
+static void runUpdates(LedControlDC &lc) {
+    while(!lc.update(millis()))
+        delay(1);
+}
+
+/* Boot screen: "8888" wiped in, "CAFE" sliding over it, then dark */
+static void bootStream(LedControlDC &lc) {
+    lc.startTransition(0,DC_TRANSITION_WIPE_DOWN,'8','8','8','8',true,DC_ORANGE,60);
+    runUpdates(lc);
+    delay(500);
+    lc.startTransition(0,DC_TRANSITION_SLIDE_LEFT,'C','A','F','E',false,DC_GREEN,80);
+    runUpdates(lc);
+    delay(1000);
+    lc.startClearAnimation(0,60);
+    runUpdates(lc);
+}
+
+/* Error code: a red "E" and the number "42" blinking, repeated */
+static void errorStream(LedControlDC &lc) {
+    static const DC_COLOR colors[4]={DC_RED,DC_NONE,DC_ORANGE,DC_ORANGE};
+    lc.printColors(0,'E',' ','4','2',false,colors);
+    lc.blink(0,0x0C,250);
+    lc.update(millis());
+    //one on and one off phase, the stream repeats them
+    unsigned long start=millis();
+    while(millis()-start<499) {
+        delay(1);
+        lc.update(millis());
+    }
+}
+
+/* Attract loop: the digits counting up in changing colors, repeated */
+static void attractStream(LedControlDC &lc) {
+    static const DC_COLOR colors[3]={DC_GREEN,DC_ORANGE,DC_RED};
+    for(int i=0;i<10;i++) {
+        char c='0'+i;
+        lc.startTransition(0,DC_TRANSITION_CROSSFADE,c,c,c,c,false,colors[i%3],40);
+        runUpdates(lc);
+        delay(300);
+    }
+}
+
+struct Stream {
+    const char *name;
+    void (*draw)(LedControlDC &lc);
+    bool repeat;
+};
+
+static const Stream streams[]={
+    { "bootStream",    bootStream,    false },
+    { "errorStream",   errorStream,   true },
+    { "attractStream", attractStream, true },
+};
+
+int main(int argc, char **argv) {
+    FILE *out=stdout;
+
+    if(argc>1) {
+        out=fopen(argv[1],"w");
+        if(!out) {
+            perror(argv[1]);
+            return 1;
+        }
+    }
+    fprintf(out,"// Frame streams for one device, made by extras/host ledstream\n");
+    for(unsigned int s=0;s<sizeof(streams)/sizeof(streams[0]);s++) {
+        LedStreamWriter writer;
+        LedControlDC lc(writer,1);
+        //the same setup as the sketch, it is not part of the stream
+        lc.shutdown(0,false);
+        lc.setIntensity(0,8);
+        writer.start();
+        streams[s].draw(lc);
+        writer.end(streams[s].repeat);
+        fprintf(out,"\n");
+        writer.writeArray(out,streams[s].name);
+    }
+    if(out!=stdout)
+        fclose(out);
+    return 0;
+}
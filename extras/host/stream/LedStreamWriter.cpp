@@ -0,0 +1,107 @@
+/*
+ * LedStreamWriter.cpp - Record the frames of a LedControl as a frame stream
+ */
+
+#include "LedStreamWriter.h"
+
+LedStreamWriter::LedStreamWriter() {
+    recording=false;
+    lastMs=0;
+}
+
+void LedStreamWriter::begin() {
+}
+
+void LedStreamWriter::writeWait() {
+    unsigned long ms=millis();
+    unsigned long wait=ms-lastMs;
+
+    //longer waits are split, a record holds 16 bits
+    while(wait>0) {
+        unsigned long part=wait>0xFFFF ? 0xFFFF : wait;
+        records.push_back(LED_STREAM_WAIT);
+        records.push_back(part & 0xFF);
+        records.push_back(part >> 8);
+        wait-=part;
+    }
+    lastMs=ms;
+}
+
+void LedStreamWriter::writeRecords(const std::vector<int> &target) {
+    int devices=regs.size()/16;
+
+    //one record for each register that changes, mostly there is one
+    for(int opcode=1;opcode<16;opcode++) {
+        std::vector<uint8_t> pairs;
+        for(int i=0;i<devices;i++) {
+            int value=target[i*16+opcode];
+            if(value<0 || regs[i*16+opcode]==value)
+                continue;
+            regs[i*16+opcode]=value;
+            pairs.push_back(i);
+            pairs.push_back(value);
+        }
+        if(!recording || pairs.empty())
+            continue;
+        records.push_back(opcode);
+        records.push_back(pairs.size()/2);
+        records.insert(records.end(),pairs.begin(),pairs.end());
+    }
+}
+
+void LedStreamWriter::transfer(const byte *data, int count) {
+    int devices=count/2;
+
+    if((int)regs.size()<devices*16)
+        regs.resize(devices*16,-1);
+    if(recording)
+        writeWait();
+    std::vector<int> target=regs;
+    for(int i=0;i<devices;i++) {
+        //the last device on the chain is shifted out first
+        int offset=(devices-1-i)*2;
+        if(data[offset]!=0 && data[offset]<16)
+            target[i*16+data[offset]]=data[offset+1];
+    }
+    writeRecords(target);
+}
+
+void LedStreamWriter::start() {
+    records.clear();
+    startRegs=regs;
+    recording=true;
+    lastMs=millis();
+}
+
+void LedStreamWriter::end(bool repeat) {
+    if(!recording)
+        return;
+    writeWait();
+    if(repeat) {
+        std::vector<int> target=startRegs;
+        target.resize(regs.size(),-1);
+        //registers the stream sets before its first wait need no reset
+        for(size_t pos=0;pos<records.size() && records[pos]<16;) {
+            int opcode=records[pos];
+            int count=records[pos+1];
+            for(int i=0;i<count;i++)
+                target[records[pos+2+i*2]*16+opcode]=-1;
+            pos+=2+count*2;
+        }
+        writeRecords(target);
+    }
+    records.push_back(repeat ? LED_STREAM_REPEAT : LED_STREAM_END);
+    recording=false;
+}
+
+const std::vector<uint8_t> &LedStreamWriter::getStream() {
+    return records;
+}
+
+void LedStreamWriter::writeArray(FILE *out, const char *name) {
+    fprintf(out,"// %u bytes\n",(unsigned int)records.size());
+    fprintf(out,"const byte %s[] PROGMEM = {",name);
+    for(size_t i=0;i<records.size();i++)
+        fprintf(out,"%s0x%02X%s",i%12 ? "" : "\n  ",records[i],i+1<records.size() ? "," : "");
+    fprintf(out,"\n};\n");
+}
@@ -0,0 +1,75 @@
+/*
+ * LedStreamWriter.h - Record the frames of a LedControl as a frame stream
+ *
+ * The writer is the transport of a LedControl/LedControlDC on the host.
+ * After start() every frame the library sends is turned into a frame 
+ * record (see LedStream.h) holding only the registers that really change,
+ * and the time between frames, read with millis(), into LED_STREAM_WAIT
+ * records. Registers sent before start() are remembered but not recorded,
+ * so the setup of the display is left to the sketch playing the stream.
+ */
+
+#ifndef LedStreamWriter_h
+#define LedStreamWriter_h
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <vector>
+#include "LedTransport.h"
+#include "LedStream.h"
+
+class LedStreamWriter: public LedTransport {
+    private :
+        /* The records written so far */
+        std::vector<uint8_t> records;
+        /* The 16 registers of every device as the player will have them,
+           -1 if not known yet */
+        std::vector<int> regs;
+        /* The registers at start(), a repeated stream returns to them */
+        std::vector<int> startRegs;
+        /* True between start() and end() */
+        bool recording;
+        /* The time of the last record in ms */
+        unsigned long lastMs;
+
+        void writeWait();
+        void writeRecords(const std::vector<int> &target);
+
+    public:
+        LedStreamWriter();
+
+        void begin();
+        void transfer(const byte *data, int count);
+
+        /*
+         * Forget the records and record from now on.
+         */
+        void start();
+
+        /*
+         * Finish the stream. The time since the last frame is kept as a
+         * wait, so a repeated stream shows its last frame as long. A 
+         * repeated stream then sets the registers back to what they were
+         * at start(), the frames recorded after it build on that.
+         * Params :
+         * repeat	true to play the stream again and again
+         */
+        void end(bool repeat=false);
+
+        /*
+         * Gets the stream.
+         * Returns :
+         * std::vector	the bytes of the stream
+         */
+        const std::vector<uint8_t> &getStream();
+
+        /*
+         * Write the stream as a PROGMEM array for a sketch.
+         * Params :
+         * out	the file to write to
+         * name	the name of the array
+         */
+        void writeArray(FILE *out, const char *name);
+};
+
+#endif	//LedStreamWriter.h
@@ -0,0 +1,748 @@
+/*
+ * LedTest.cpp - Checks of the library against the simulated chain
+ *
+ * Every public call is run on chains of 1 to 8 devices connected to the
+ * simulator. After each call the rows latched in the devices must be the
+ * rows the library has in its led-status, and the intensity, scan limit
+ * and shutdown registers the values it reports.
+ *
+ * clearAnimation() and printAnimation() are checked step by step against
+ * a model of the original implementation, which masked the image of one
+ * digit after the other with the values in mask_array and waited tm ms
+ * after each step. startClearAnimation()/startPrintAnimation() have to
+ * show the same sequence driven by update().
+ *
+ * A controler that was moved must drive the chain, the one it was moved
+ * from must send nothing.
+ *
+ * The queue must send its frames with interrupts on, also when it is full,
+ * and a service() from an interrupt must not disturb one that runs.
+ *
+ * A LedGroupTransport must give each chain its own devices and must not
+ * select a chain that gets only no-ops.
+ *
+ * LedControlDCFast and LedControlFast (LedControlFast.h) must drive the
+ * chain like the classes they replace.
+ *
+ * Blending must switch the color of orange digits only.
+ *
+ * getGlyph() and the digits shown must come from the font: the table, the
+ * fallback for codes it does not have (also negative chars) and the next
+ * font of a chain. print() and printNumber() over the whole chain must
+ * show the digits they are given, aligned left or right.
+ *
+ * The program prints every failed check and returns 1 if there was one.
+ *
+ *   ledtest
+ */
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <vector>
+#include <utility>
+#include "LedControlDC.h"
+#include "LedControlFast.h"
+#include "Max7219Sim.h"
+
+#define DATA_PIN 12
+#define CLK_PIN  11
+#define CS_PIN   10
+
+static int failures=0;
+
+#define CHECK(cond, ...) do { \
+    if(!(cond)) { \
+        printf("FAIL %s:%d: ",__FILE__,__LINE__); \
+        printf(__VA_ARGS__); \
+        printf("\n"); \
+        failures++; \
+    } \
+} while(0)
+
+/* A call, run on the chain after the calls before it */
+typedef void (*TestCall)(LedControlDC &lc);
+
+struct Test {
+    const char *name;
+    TestCall call;
+};
+
+static LedQueueOp queueBuffer[80];
+
+static void callInit(LedControlDC &lc) {
+    (void)lc;
+}
+
+static void callWake(LedControlDC &lc) {
+    lc.shutdownAll(false);
+    lc.setIntensityAll(8);
+    lc.setScanLimit(0,7);
+}
+
+static void callSetLed(LedControlDC &lc) {
+    lc.setLed(lc.getDeviceCount()-1,3,4,true);
+    lc.setLed(0,7,0,true);
+}
+
+static void callSetRow(LedControlDC &lc) {
+    lc.setRow(lc.getDeviceCount()-1,3,B01010101);
+}
+
+static void callSetColumn(LedControlDC &lc) {
+    lc.setColumn(lc.getDeviceCount()-1,4,B11111111);
+}
+
+static void callSetDigit(LedControlDC &lc) {
+    lc.LedControl::setDigit(lc.getDeviceCount()-1,3,8,true);
+}
+
+static void callSetChar(LedControlDC &lc) {
+    lc.LedControl::setChar(0,2,'H',false);
+}
+
+static void callClearDisplay(LedControlDC &lc) {
+    lc.clearDisplay(lc.getDeviceCount()-1);
+}
+
+static void callSetCharDC(LedControlDC &lc) {
+    lc.setCharDC(0,1,'8',true,'3',false);
+}
+
+static void callSetCharColor(LedControlDC &lc) {
+    lc.setChar(lc.getDeviceCount()-1,0,'7',true,DC_GREEN);
+}
+
+static void callPrint(LedControlDC &lc) {
+    for(int i=0;i<lc.getDeviceCount();i++)
+        lc.print(i,'1','2','3','4',true,DC_ORANGE);
+}
+
+static void callPrintColors(LedControlDC &lc) {
+    static const DC_COLOR colors[4]={DC_RED,DC_GREEN,DC_ORANGE,DC_RED};
+    lc.printColors(0,'5','6','7','8',false,colors);
+}
+
+static void callPrintText(LedControlDC &lc) {
+    lc.print("12.345678901234567890123456789012",DC_ORANGE);
+}
+
+static void callPrintMarkup(LedControlDC &lc) {
+    lc.printMarkup("#R12.34#G5678#O9012#R3456#G7890#O1234#R5678#G9012",DC_ALIGN_RIGHT);
+}
+
+static void callPrintNumber(LedControlDC &lc) {
+    lc.printNumber(-12345,2,DC_RED);
+}
+
+static void callClear(LedControlDC &lc) {
+    lc.clear(0);
+}
+
+static void callFill(LedControlDC &lc) {
+    lc.fill(DC_GREEN);
+}
+
+static void callInvert(LedControlDC &lc) {
+    lc.invert();
+}
+
+static void callSwapColors(LedControlDC &lc) {
+    lc.print("8.8.8.8.8.8.8.8.8.8.8.8.8.8.8.8.8.8",DC_RED);
+    lc.swapColors();
+}
+
+static void callBuffered(LedControlDC &lc) {
+    lc.setBuffered(true);
+    lc.print("ABCDEFGHIJKLMNOPQRSTUVWXYZ012345",DC_ORANGE);
+    lc.commit();
+    lc.setBuffered(false);
+}
+
+static void callSwap(LedControlDC &lc) {
+    lc.swap();
+    lc.print("98765432109876543210987654321098",DC_GREEN);
+    lc.swap();
+    lc.setBuffered(false);
+}
+
+static void callQueue(LedControlDC &lc) {
+    lc.setQueue(queueBuffer,80);
+    lc.print("12345678901234567890123456789012",DC_RED);
+    while(!lc.service());
+    lc.setQueue(NULL,0);
+}
+
+static void callScroll(LedControlDC &lc) {
+    lc.startScroll("HELLO 12.34",DC_ORANGE,100,false);
+    for(uint32_t ms=0;lc.isScrolling();ms+=100)
+        lc.update(ms);
+}
+
+static void callBlend(LedControlDC &lc) {
+    lc.print("8888888888888888888888888888888",DC_ORANGE);
+    for(int i=0;i<lc.getDeviceCount();i++)
+        lc.setBlend(i,5);
+    for(int i=0;i<7;i++)
+        lc.tick();
+    for(int i=0;i<lc.getDeviceCount();i++)
+        lc.setBlend(i,0);
+}
+
+static void callBlink(LedControlDC &lc) {
+    lc.blink(0,0x05,500);
+    lc.update(0);
+    lc.update(500);
+}
+
+static void callUnblink(LedControlDC &lc) {
+    lc.blink(0,0,0);
+}
+
+static void callFade(LedControlDC &lc) {
+    lc.fadeAllTo(2,1000);
+    lc.update(0);
+    lc.update(400);
+    lc.update(1000);
+}
+
+static void callResync(LedControlDC &lc) {
+    lc.resync();
+    while(!lc.updateResync(0));
+}
+
+static void callClearAll(LedControlDC &lc) {
+    lc.clearAll();
+}
+
+static void callShutdown(LedControlDC &lc) {
+    lc.shutdown(lc.getDeviceCount()-1,true);
+    lc.setIntensity(0,15);
+}
+
+static const Test tests[] = {
+    { "init",          callInit },
+    { "wake",          callWake },
+    { "setLed",        callSetLed },
+    { "setRow",        callSetRow },
+    { "setColumn",     callSetColumn },
+    { "setDigit",      callSetDigit },
+    { "setChar",       callSetChar },
+    { "clearDisplay",  callClearDisplay },
+    { "setCharDC",     callSetCharDC },
+    { "setChar_color", callSetCharColor },
+    { "print",         callPrint },
+    { "printColors",   callPrintColors },
+    { "print_text",    callPrintText },
+    { "printMarkup",   callPrintMarkup },
+    { "printNumber",   callPrintNumber },
+    { "clear",         callClear },
+    { "fill",          callFill },
+    { "invert",        callInvert },
+    { "swapColors",    callSwapColors },
+    { "buffered",      callBuffered },
+    { "swap",          callSwap },
+    { "queue",         callQueue },
+    { "scroll",        callScroll },
+    { "blend",         callBlend },
+    { "blink",         callBlink },
+    { "unblink",       callUnblink },
+    { "fade",          callFade },
+    { "resync",        callResync },
+    { "clearAll",      callClearAll },
+    { "shutdown",      callShutdown },
+};
+
+/* The chain has to show what the library thinks it shows */
+static void checkChain(const char *name, LedControlDC &lc, Max7219Sim &sim) {
+    int devices=lc.getDeviceCount();
+    std::vector<uint8_t> status(devices*8);
+
+    for(int i=0;i<devices;i++) {
+        for(int row=0;row<8;row++)
+            status[i*8+row]=lc.getRow(i,row);
+    }
+    if(!sim.rowsEqual(status.data())) {
+        for(int i=0;i<devices*8;i++) {
+            CHECK(sim.getRow(i/8,i%8)==status[i],"%s, %d devices: row %d of device %d is %02x not %02x",
+                name,devices,i%8,i/8,sim.getRow(i/8,i%8),status[i]);
+        }
+    }
+    for(int i=0;i<devices;i++) {
+        CHECK(lc.getIntensity(i)<0 || sim.getIntensity(i)==lc.getIntensity(i),
+            "%s, %d devices: intensity of device %d",name,devices,i);
+        CHECK(sim.getScanLimit(i)==lc.getScanLimit(i),
+            "%s, %d devices: scan limit of device %d",name,devices,i);
+        CHECK(sim.isShutdown(i)==lc.isShutdown(i),
+            "%s, %d devices: shutdown of device %d",name,devices,i);
+    }
+}
+
+static void testCalls() {
+    for(int devices=1;devices<=8;devices++) {
+        hostSetMicros(0);
+        Max7219Sim sim(DATA_PIN,CLK_PIN,CS_PIN,devices);
+        LedControlDC lc(DATA_PIN,CLK_PIN,CS_PIN,devices);
+
+        for(unsigned int t=0;t<sizeof(tests)/sizeof(tests[0]);t++) {
+            tests[t].call(lc);
+            checkChain(tests[t].name,lc,sim);
+        }
+    }
+}
+
+/* A moved controler drives the chain, the one it was moved from nothing */
+static void testMove() {
+    hostSetMicros(0);
+    Max7219Sim sim(DATA_PIN,CLK_PIN,CS_PIN,2);
+    LedControlDC lc=LedControlDC(DATA_PIN,CLK_PIN,CS_PIN,2);
+
+    callWake(lc);
+    lc.print(0,'1','2','3','4',true,DC_RED);
+    LedControlDC moved(std::move(lc));
+    checkChain("move",moved,sim);
+    CHECK(lc.getDeviceCount()==0,"move: the old controler has %d devices",lc.getDeviceCount());
+
+    unsigned long frames=sim.getFrameCount();
+    lc.print(1,'5','6','7','8',false,DC_GREEN);
+    lc.clearAll();
+    lc.update(100);
+    CHECK(sim.getFrameCount()==frames,"move: the old controler sent %lu frames",
+        sim.getFrameCount()-frames);
+
+    moved.print(1,'5','6','7','8',false,DC_GREEN);
+    checkChain("move print",moved,sim);
+}
+
+/* Pin changes made with interrupts off. While isrControler is set every
+   rising clock edge runs its service() as a timer interrupt would */
+static unsigned long lockedWrites;
+static LedControlDC *isrControler;
+static int isrCalls;
+static int isrBusy;
+
+static void onPin(void *context, uint8_t pin, uint8_t val) {
+    (void)context;
+    if(!hostInterruptsEnabled())
+        lockedWrites++;
+    if(isrControler && pin==CLK_PIN && val==HIGH) {
+        LedControlDC *lc=isrControler;
+        //no interrupt during the interrupt
+        isrControler=NULL;
+        if(!lc->service())
+            isrBusy++;
+        isrCalls++;
+        isrControler=lc;
+    }
+}
+
+/* A full queue and switching it off send with interrupts on, and a 
+   service() from an interrupt leaves a frame being sent alone */
+static void testQueue() {
+    static LedQueueOp smallQueue[3];
+
+    hostSetMicros(0);
+    Max7219Sim sim(DATA_PIN,CLK_PIN,CS_PIN,4);
+    LedControlDC lc(DATA_PIN,CLK_PIN,CS_PIN,4);
+    callWake(lc);
+
+    lockedWrites=0;
+    isrCalls=0;
+    isrBusy=0;
+    hostAddPinHook(onPin,NULL);
+    lc.setQueue(smallQueue,3);
+    isrControler=&lc;
+    lc.print("1234567890abcdef",DC_GREEN);
+    lc.setQueue(NULL,0);
+    isrControler=NULL;
+    hostRemovePinHook(onPin,NULL);
+
+    checkChain("full queue",lc,sim);
+    CHECK(lockedWrites==0,"full queue: %lu pin changes with interrupts off",lockedWrites);
+    CHECK(hostInterruptsEnabled(),"full queue: interrupts are off");
+    CHECK(isrCalls>0 && isrBusy==isrCalls,"full queue: %d of %d interrupts sent during a frame",
+        isrCalls-isrBusy,isrCalls);
+}
+
+/* Devices 0,1 of lc are chain a, devices 2,3 chain b */
+static void checkGroup(const char *name, LedControlDC &lc, Max7219Sim &a, Max7219Sim &b) {
+    for(int i=0;i<4;i++) {
+        Max7219Sim &sim=i<2 ? a : b;
+        for(int row=0;row<8;row++)
+            CHECK(sim.getRow(i%2,row)==lc.getRow(i,row),"%s: row %d of device %d is %02x not %02x",
+                name,row,i,sim.getRow(i%2,row),lc.getRow(i,row));
+        CHECK(lc.getIntensity(i)<0 || sim.getIntensity(i%2)==lc.getIntensity(i),
+            "%s: intensity of device %d",name,i);
+        CHECK(sim.isShutdown(i%2)==lc.isShutdown(i),"%s: shutdown of device %d",name,i);
+    }
+    CHECK(a.getShortFrameCount()==0 && b.getShortFrameCount()==0,"%s: a chain got a short frame",name);
+}
+
+/* Two chains on their own chip select lines: each gets its slice of the
+   frame, a chain with only no-ops in it is not selected */
+static void testGroup() {
+    hostSetMicros(0);
+    Max7219Sim a(DATA_PIN,CLK_PIN,CS_PIN,2);
+    Max7219Sim b(DATA_PIN,CLK_PIN,CS_PIN-1,2);
+    LedBitBangTransport chainA(DATA_PIN,CLK_PIN,CS_PIN);
+    LedBitBangTransport chainB(DATA_PIN,CLK_PIN,CS_PIN-1);
+    LedTransport *chains[] = { &chainA, &chainB };
+    LedGroupTransport group(chains,2,2);
+    LedControlDC lc(group,4);
+    //begin() raised chip select b for the first time, that latched nothing
+    a.resetCounters();
+    b.resetCounters();
+
+    callWake(lc);
+    lc.setIntensityAll(3);
+    checkGroup("group wake",lc,a,b);
+
+    unsigned long framesA=a.getFrameCount();
+    unsigned long framesB=b.getFrameCount();
+    lc.print(0,'1','2','3','4',true,DC_RED);
+    lc.setIntensity(1,9);
+    checkGroup("group chain a",lc,a,b);
+    CHECK(a.getFrameCount()>framesA,"group: chain a got no frame");
+    CHECK(b.getFrameCount()==framesB,"group: chain b was selected %lu times for chain a",
+        b.getFrameCount()-framesB);
+
+    framesA=a.getFrameCount();
+    framesB=b.getFrameCount();
+    lc.print(3,'5','6','7','8',false,DC_GREEN);
+    lc.shutdown(2,true);
+    checkGroup("group chain b",lc,a,b);
+    CHECK(b.getFrameCount()>framesB,"group: chain b got no frame");
+    CHECK(a.getFrameCount()==framesA,"group: chain a was selected %lu times for chain b",
+        a.getFrameCount()-framesA);
+
+    lc.print("0123456789abcdef",DC_ORANGE);
+    lc.clearAll();
+    checkGroup("group both",lc,a,b);
+}
+
+/* LedControlDCFast runs every call like LedControlDC, LedControlFast 
+   the calls of LedControl */
+static void testFast() {
+    {
+        hostSetMicros(0);
+        Max7219Sim sim(DATA_PIN,CLK_PIN,CS_PIN,3);
+        LedControlDCFast<DATA_PIN,CLK_PIN,CS_PIN,3> lc;
+        sim.resetCounters();
+
+        for(unsigned int t=0;t<sizeof(tests)/sizeof(tests[0]);t++) {
+            tests[t].call(lc);
+            checkChain(tests[t].name,lc,sim);
+        }
+        CHECK(sim.getFrameCount()>0 && sim.getShortFrameCount()==0,
+            "LedControlDCFast: %lu frames, %lu short",sim.getFrameCount(),sim.getShortFrameCount());
+    }
+    {
+        hostSetMicros(0);
+        Max7219Sim sim(DATA_PIN,CLK_PIN,CS_PIN,2);
+        LedControlFast<DATA_PIN,CLK_PIN,CS_PIN,2> lc;
+
+        lc.shutdownAll(false);
+        lc.setScanLimit(0,7);
+        lc.setScanLimit(1,7);
+        lc.setIntensity(1,5);
+        lc.setRow(0,3,B10100101);
+        lc.setColumn(1,2,B00111100);
+        lc.setLed(0,7,7,true);
+        lc.setDigit(1,0,7,true);
+        lc.setChar(0,6,'A',false);
+        for(int i=0;i<2;i++) {
+            for(int row=0;row<8;row++)
+                CHECK(sim.getRow(i,row)==lc.getRow(i,row),"LedControlFast: row %d of device %d is %02x not %02x",
+                    row,i,sim.getRow(i,row),lc.getRow(i,row));
+            CHECK(!sim.isShutdown(i),"LedControlFast: device %d is shut down",i);
+            CHECK(sim.getScanLimit(i)==7,"LedControlFast: scan limit of device %d",i);
+        }
+        CHECK(sim.getIntensity(1)==5,"LedControlFast: intensity of device 1");
+        CHECK(sim.getRow(0,3)==B10100101,"LedControlFast: setRow() not shown");
+    }
+}
+
+/* Red and green image of the 4 digits of device 0 */
+struct Images {
+    uint8_t r[4];
+    uint8_t g[4];
+
+    bool operator==(const Images &o) const {
+        for(int i=0;i<4;i++) {
+            if(r[i]!=o.r[i] || g[i]!=o.g[i])
+                return false;
+        }
+        return true;
+    }
+    bool operator!=(const Images &o) const {
+        return !(*this==o);
+    }
+};
+
+static uint8_t columnImage(Max7219Sim &sim, int addr, uint8_t column) {
+    uint8_t img=0;
+    for(int row=0;row<8;row++) {
+        if(sim.getRow(addr,row) & column)
+            img|=B10000000 >> row;
+    }
+    return img;
+}
+
+static Images shown(Max7219Sim &sim, int addr=0) {
+    Images img;
+    for(int i=0;i<4;i++) {
+        img.r[i]=columnImage(sim,addr,DC_LAYOUT_DEFAULT.red[i]);
+        img.g[i]=columnImage(sim,addr,DC_LAYOUT_DEFAULT.green[i]);
+    }
+    return img;
+}
+
+/* The images shown at every delay() */
+static Max7219Sim *stepSim;
+static std::vector<Images> steps;
+
+static void onDelay(void *context, unsigned long ms) {
+    (void)context;
+    (void)ms;
+    steps.push_back(shown(*stepSim));
+}
+
+/* Only the changes, a step that changes nothing is not seen on update() */
+static std::vector<Images> changes(const Images &start, const std::vector<Images> &seq) {
+    std::vector<Images> out;
+    Images last=start;
+    for(unsigned int i=0;i<seq.size();i++) {
+        if(seq[i]!=last)
+            out.push_back(seq[i]);
+        last=seq[i];
+    }
+    return out;
+}
+
+/* clearAnimation() as it was: digit by digit, 3 masks each */
+static void modelClear(Images img, std::vector<Images> &seq) {
+    const uint8_t mask_array[] = {0b11110011,0b01100001,0b00000000};
+    Images old=img;
+    for(int i=0;i<4;i++) {
+        for(int j=0;j<3;j++) {
+            uint8_t mask;
+            if(i==2)mask=mask_array[j]&0b11111110;
+            else mask=mask_array[j];
+            img.r[i]=old.r[i]&mask;
+            img.g[i]=old.g[i]&mask;
+            seq.push_back(img);
+        }
+    }
+}
+
+/* printAnimation() as it was */
+static void modelPrint(LedControlDC &lc, Images img, const char *v, bool dp, DC_COLOR color,
+        std::vector<Images> &seq) {
+    const uint8_t mask_array[] = {0b00001100,0b10011111,0b11111111};
+    for(int i=0;i<4;i++) {
+        uint8_t z=lc.getGlyph(v[i]);
+        if(dp && (i==1 || i==2))
+            z|=0b00000001;
+        for(int j=0;j<3;j++) {
+            img.r[i]=(color & DC_RED) ? z & mask_array[j] : 0;
+            img.g[i]=(color & DC_GREEN) ? z & mask_array[j] : 0;
+            seq.push_back(img);
+        }
+    }
+}
+
+static void checkSteps(const char *name, const std::vector<Images> &got,
+        const std::vector<Images> &want) {
+    CHECK(got.size()==want.size(),"%s: %u steps instead of %u",name,
+        (unsigned)got.size(),(unsigned)want.size());
+    for(unsigned int i=0;i<got.size() && i<want.size();i++)
+        CHECK(got[i]==want[i],"%s: step %u differs",name,i);
+}
+
+static void testAnimations() {
+    const char *text[] = { "5678", "-23~", "    " };
+    const bool dp[] = { true, false, true };
+    const DC_COLOR color[] = { DC_ORANGE, DC_GREEN, DC_RED };
+
+    for(int a=0;a<3;a++) {
+        Max7219Sim sim(DATA_PIN,CLK_PIN,CS_PIN,1);
+        LedControlDC lc(DATA_PIN,CLK_PIN,CS_PIN,1);
+        std::vector<Images> want;
+        Images start;
+
+        //the blocking calls, one step per delay()
+        lc.print(0,'1','2','3','4',true,DC_RED);
+        start=shown(sim);
+        modelClear(start,want);
+        modelPrint(lc,want.back(),text[a],dp[a],color[a],want);
+        stepSim=&sim;
+        steps.clear();
+        hostSetDelayHook(onDelay,NULL);
+        lc.clearAnimation(0,50);
+        lc.printAnimation(0,text[a][0],text[a][1],text[a][2],text[a][3],dp[a],color[a],50);
+        hostSetDelayHook(NULL,NULL);
+        checkSteps("clearAnimation/printAnimation",steps,want);
+
+        //the same steps from update()
+        lc.print(0,'1','2','3','4',true,DC_RED);
+        lc.startPrintAnimation(0,text[a][0],text[a][1],text[a][2],text[a][3],dp[a],color[a],50,true);
+        steps.clear();
+        Images last=start;
+        for(uint32_t ms=0;;ms+=7) {
+            bool done=lc.update(ms);
+            Images now=shown(sim);
+            if(now!=last)
+                steps.push_back(now);
+            last=now;
+            if(done)
+                break;
+        }
+        checkSteps("startPrintAnimation",steps,changes(start,want));
+    }
+}
+
+/* Blending switches only orange digits, a digit with a different image in
+   each color keeps its shapes */
+static void testBlend() {
+    hostSetMicros(0);
+    Max7219Sim sim(DATA_PIN,CLK_PIN,CS_PIN,1);
+    LedControlDC lc(DATA_PIN,CLK_PIN,CS_PIN,1);
+    callWake(lc);
+
+    lc.print(0,'8','8','8','8',false,DC_ORANGE);
+    lc.setCharDC(0,1,'8',true,'3',false);
+    Images start=shown(sim);
+    lc.setBlend(0,5);
+    int red=0;
+    for(int i=0;i<16;i++) {
+        lc.tick();
+        Images now=shown(sim);
+        CHECK(now.r[1]==start.r[1] && now.g[1]==start.g[1],
+            "blend: tick %d changed the red/green digit",i);
+        //the orange digits show one color or the other
+        CHECK((now.r[0]==start.r[0] && now.g[0]==0) || (now.r[0]==0 && now.g[0]==start.g[0]),
+            "blend: tick %d shows digit 0 in both colors",i);
+        if(now.r[0])
+            red++;
+    }
+    CHECK(red==5,"blend: red in %d of 16 ticks instead of 5",red);
+    lc.setBlend(0,0);
+    CHECK(shown(sim)==start,"blend: the digits are not orange again");
+}
+
+/* Sparse fonts for the codes 0xC0..0xC2 and 0xFF, chained to the built-in one */
+static const uint8_t cyrillicGlyphs[] PROGMEM = { 0b11101110, 0b10111110, 0b11111110 };
+static const uint8_t lastGlyph[] PROGMEM = { 0b10010010 };
+static const DCFont cyrillicFont = { cyrillicGlyphs, 0xC0, 3, 0b00000000, &DC_FONT_DEFAULT };
+static const DCFont chainedFont = { lastGlyph, 0xFF, 1, 0b00000010, &cyrillicFont };
+static const DCFont fallbackFont = { characterArrayDC, 0, 128, 0b10000000, NULL };
+
+/* Codes outside a font, negative chars, the fallback and chained fonts,
+   by getGlyph() and on the chain */
+static void testFonts() {
+    hostSetMicros(0);
+    Max7219Sim sim(DATA_PIN,CLK_PIN,CS_PIN,1);
+    LedControlDC lc(DATA_PIN,CLK_PIN,CS_PIN,1);
+    callWake(lc);
+
+    //the built-in font: 0..127 from the table, blank above
+    CHECK(lc.getFont().first==0 && lc.getFont().count==128 && !lc.getFont().next,
+        "font: not the built-in font");
+    CHECK(lc.getGlyph('8')==characterArrayDC['8'],"font: glyph of '8'");
+    CHECK(lc.getGlyph(127)==characterArrayDC[127],"font: glyph of 127");
+    CHECK(lc.getGlyph((char)128)==0,"font: glyph of 128 is %02x",lc.getGlyph((char)128));
+    CHECK(lc.getGlyph((char)0xFF)==0,"font: glyph of 0xFF is %02x",lc.getGlyph((char)0xFF));
+    CHECK(lc.getGlyph((char)-1)==0,"font: glyph of -1 is %02x",lc.getGlyph((char)-1));
+    CHECK(lc.getGlyph((char)-128)==0,"font: glyph of -128 is %02x",lc.getGlyph((char)-128));
+
+    //the fallback of the font for every code it does not have
+    lc.setFont(fallbackFont);
+    CHECK(lc.getGlyph('8')==characterArrayDC['8'],"fallback: glyph of '8'");
+    CHECK(lc.getGlyph((char)200)==0b10000000,"fallback: glyph of 200 is %02x",lc.getGlyph((char)200));
+    CHECK(lc.getGlyph((char)-56)==0b10000000,"fallback: glyph of -56 is %02x",lc.getGlyph((char)-56));
+
+    //chained sparse fonts, the fallback of the first one
+    lc.setFont(chainedFont);
+    CHECK(&lc.getFont()==&chainedFont,"chain: getFont() is not the font set");
+    CHECK(lc.getGlyph((char)0xFF)==lastGlyph[0],"chain: glyph of 0xFF");
+    for(int i=0;i<3;i++)
+        CHECK(lc.getGlyph((char)(0xC0+i))==cyrillicGlyphs[i],"chain: glyph of %02x",0xC0+i);
+    CHECK(lc.getGlyph('A')==characterArrayDC['A'],"chain: glyph of 'A'");
+    CHECK(lc.getGlyph((char)0xBF)==0b00000010,"chain: glyph of 0xBF is %02x",lc.getGlyph((char)0xBF));
+    CHECK(lc.getGlyph((char)0xC3)==0b00000010,"chain: glyph of 0xC3 is %02x",lc.getGlyph((char)0xC3));
+
+    //what the chain shows, with the point of digit 1
+    lc.print(0,(char)0xC1,(char)0xFF,'3',(char)0xE0,true,DC_GREEN);
+    Images img=shown(sim);
+    const uint8_t want[4] = { cyrillicGlyphs[1], (uint8_t)(lastGlyph[0] | 1), 
+        (uint8_t)(characterArrayDC['3'] | 1), 0b00000010 };
+    for(int i=0;i<4;i++) {
+        CHECK(img.g[i]==want[i],"chain: digit %d shows %02x not %02x",i,img.g[i],want[i]);
+        CHECK(img.r[i]==0,"chain: digit %d is red",i);
+    }
+    checkChain("fonts",lc,sim);
+}
+
+/* The 8 digits of a chain of 2 devices must show text, '.' in points 
+   marks the digits with a lit point */
+static void checkDigits(const char *name, Max7219Sim &sim, const char *text,
+        const char *points, DC_COLOR color) {
+    for(int d=0;d<2;d++) {
+        Images img=shown(sim,d);
+        for(int i=0;i<4;i++) {
+            int digit=d*4+i;
+            uint8_t want=characterArrayDC[(int)text[digit]] | (points[digit]=='.' ? 1 : 0);
+            CHECK(img.r[i]==((color & DC_RED) ? want : 0) && img.g[i]==((color & DC_GREEN) ? want : 0),
+                "%s: digit %d shows %02x/%02x, not '%c' (%02x)",name,digit,img.r[i],img.g[i],
+                text[digit],want);
+        }
+    }
+}
+
+/* Text and numbers over the whole chain, both alignments, in one update */
+static void testPrintChain() {
+    hostSetMicros(0);
+    Max7219Sim sim(DATA_PIN,CLK_PIN,CS_PIN,2);
+    LedControlDC lc(DATA_PIN,CLK_PIN,CS_PIN,2);
+    callWake(lc);
+
+    sim.resetCounters();
+    lc.printNumber(-1234,2,DC_RED);
+    checkDigits("printNumber(-1234,2)",sim,"   -1234","     .  ",DC_RED);
+    CHECK(sim.getFrameCount()<=8,"printNumber: %lu frames for the chain",
+        sim.getFrameCount());
+    lc.printNumber(-7,1,DC_GREEN);
+    checkDigits("printNumber(-7,1)",sim,"     -07","      . ",DC_GREEN);
+    lc.printNumber(0,0,DC_ORANGE);
+    checkDigits("printNumber(0,0)",sim,"       0","        ",DC_ORANGE);
+    lc.printNumber(5,3,DC_GREEN,DC_ALIGN_LEFT);
+    checkDigits("printNumber(5,3) left",sim,"0005    ",".       ",DC_GREEN);
+    //too long numbers show their end
+    lc.printNumber(123456789,0,DC_RED);
+    checkDigits("printNumber(123456789,0)",sim,"23456789","        ",DC_RED);
+
+    lc.print("12",DC_RED,DC_ALIGN_RIGHT);
+    checkDigits("print right",sim,"      12","        ",DC_RED);
+    lc.print("1.2.3",DC_ORANGE);
+    checkDigits("print left",sim,"123     ","..      ",DC_ORANGE);
+    lc.print("123456789",DC_GREEN);
+    checkDigits("print too long",sim,"12345678","        ",DC_GREEN);
+    checkChain("print chain",lc,sim);
+}
+
+int main() {
+    testCalls();
+    testMove();
+    testQueue();
+    testGroup();
+    testFast();
+    testAnimations();
+    testBlend();
+    testFonts();
+    testPrintChain();
+    if(failures) {
+        printf("%d checks failed\n",failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
@@ -43,30 +43,289 @@
 #define OP_SHUTDOWN    12
 #define OP_DISPLAYTEST 15
 
-LedControl::LedControl(int dataPin, int clkPin, int csPin, int numDevices) {
-    SPI_MOSI=dataPin;
-    SPI_CLK=clkPin;
-    SPI_CS=csPin;
-    if(numDevices<=0 || numDevices>8 )
-        numDevices=8;
+//the bits in flags[] of each device
+#define FLAG_FADING       1
+#define FLAG_FADE_WAITING 2
+//the shadow of the shutdown and display test register
+#define FLAG_RUNNING      4
+#define FLAG_DISPLAYTEST  8
+//the device is marked for commitMarked()
+#define FLAG_MARKED      16
+
+//an intensity that was never sent, it differs from every real one
+#define INTENSITY_UNKNOWN 0xFF
+
+//resyncStep when no resync runs, and the number of its frames
+#define RESYNC_IDLE   0xFF
+#define RESYNC_FRAMES 13
+
+//interrupts off while the queue indices change. AVR restores the state
+//they were in, other boards have no portable way to read it and switch
+//them on again
+static inline uint8_t lockQueue() {
+#if defined(__AVR__)
+    uint8_t sreg=SREG;
+    cli();
+    return sreg;
+#else
+    noInterrupts();
+    return 0;
+#endif
+}
+
+static inline void unlockQueue(uint8_t sreg) {
+#if defined(__AVR__)
+    SREG=sreg;
+#else
+    (void)sreg;
+    interrupts();
+#endif
+}
+
+//perceived brightness (0..255) of the intensities 0..15, gamma 2.2
+const static byte lightnessTable[16] PROGMEM = {
+    54,88,111,130,145,159,172,183,194,204,214,223,231,239,247,255
+};
+
+LedControl::LedControl(int dataPin, int clkPin, int csPin, int numDevices):
+LedControl(dataPin,clkPin,csPin,numDevices,NULL,0) {
+}
+
+LedControl::LedControl(LedTransport &transport, int numDevices):
+LedControl(transport,numDevices,NULL,0) {
+}
+
+LedControl::LedControl(int dataPin, int clkPin, int csPin, int numDevices, byte *memory, int extraSize) {
+    //only a controler on pins pays for the bit-banged transport
+    transport=new LedBitBangTransport(dataPin,clkPin,csPin);
+    ownTransport=true;
+    init(numDevices,memory,extraSize);
+}
+
+LedControl::LedControl(LedTransport &transport, int numDevices, byte *memory, int extraSize) {
+    this->transport=&transport;
+    ownTransport=false;
+    init(numDevices,memory,extraSize);
+}
+
+LedControl::LedControl(LedControl &&other):
+    spidata(other.spidata),
+    queue(other.queue),
+    queueSize(other.queueSize),
+    queueHead(other.queueHead),
+    queueTail(other.queueTail),
+    queueBusy(other.queueBusy),
+    queueData(other.queueData),
+    transport(other.transport),
+    ownTransport(other.ownTransport),
+    maxDevices(other.maxDevices),
+    front(other.front),
+    buffered(other.buffered),
+    intensity(other.intensity),
+    scanLimit(other.scanLimit),
+    decodeMode(other.decodeMode),
+    flags(other.flags),
+    fading(other.fading),
+    fadeFrom(other.fadeFrom),
+    fadeTarget(other.fadeTarget),
+    fadeStart(other.fadeStart),
+    fadeTime(other.fadeTime),
+    resyncStep(other.resyncStep),
+    resyncInterval(other.resyncInterval),
+    resyncStart(other.resyncStart),
+    stream(other.stream),
+    streamPos(other.streamPos),
+    streamProgmem(other.streamProgmem),
+    streamWaiting(other.streamWaiting),
+    streamWait(other.streamWait),
+    streamStart(other.streamStart),
+#ifdef LEDCONTROL_STATS
+    stats(other.stats),
+    frameHook(other.frameHook),
+    frameHookContext(other.frameHookContext),
+#endif
+    memory(other.memory),
+    ownMemory(other.ownMemory),
+    status(other.status),
+    dirty(other.dirty) {
+    //the RAM and the transport are ours now, other has no devices left
+    other.ownMemory=false;
+    other.ownTransport=false;
+    other.memory=NULL;
+    other.transport=NULL;
+    other.queue=NULL;
+    other.stream=NULL;
+    other.fading=false;
+    other.resyncStep=RESYNC_IDLE;
+    other.resyncInterval=0;
+    other.maxDevices=0;
+}
+
+LedControl::~LedControl() {
+    if(ownMemory)
+        free(memory);
+    if(ownTransport)
+        delete transport;
+}
+
+void LedControl::init(int numDevices, byte *memory, int extraSize) {
+    ownMemory=false;
+    if(!memory) {
+        if(numDevices<=0 || numDevices>8 )
+            numDevices=8;
+        memory=(byte *)malloc(memorySize(numDevices)+numDevices*extraSize);
+        ownMemory=true;
+    }
+    //without memory or transport there is nothing we can control
+    if(!memory || !transport)
+        numDevices=0;
+    this->memory=memory;
     maxDevices=numDevices;
-    pinMode(SPI_MOSI,OUTPUT);
-    pinMode(SPI_CLK,OUTPUT);
-    pinMode(SPI_CS,OUTPUT);
-    digitalWrite(SPI_CS,HIGH);
-    SPI_MOSI=dataPin;
-    for(int i=0;i<64;i++) 
-        status[i]=0x00;
+    buffered=false;
+    //the 4 byte values first, memory is aligned for them
+    fadeStart=(uint32_t *)memory;
+    fadeTime=fadeStart+numDevices;
+    status=(byte *)(fadeTime+numDevices);
+    front=status+numDevices*8;
+    dirty=front+numDevices*8;
+    spidata=dirty+numDevices;
+    intensity=spidata+numDevices*2;
+    scanLimit=intensity+numDevices;
+    decodeMode=scanLimit+numDevices;
+    flags=decodeMode+numDevices;
+    fadeFrom=flags+numDevices;
+    fadeTarget=fadeFrom+numDevices;
+    fading=false;
+    //the last 2 bytes per device
+    queueData=memory+memorySize(numDevices)-numDevices*2;
+    queue=NULL;
+    queueBusy=false;
+    if(transport)
+        transport->begin();
+    for(int i=0;i<numDevices;i++) {
+        dirty[i]=0x00;
+        //we do not know what a reset of the Arduino left in there
+        intensity[i]=INTENSITY_UNKNOWN;
+        flags[i]=0;
+    }
+    resyncStep=RESYNC_IDLE;
+    resyncInterval=0;
+    resyncStart=0;
+    stream=NULL;
+    streamProgmem=false;
+    streamWaiting=false;
+#ifdef LEDCONTROL_STATS
+    frameHook=NULL;
+    frameHookContext=NULL;
+    resetStats();
+#endif
+    //all devices are set up together, one transfer per command.
+    //The devices may hold anything, so nothing is skipped here.
+    forceBroadcast(OP_DISPLAYTEST,0);
+    //scanlimit is set to max on startup
+    forceBroadcast(OP_SCANLIMIT,7);
+    //decode is done in source
+    forceBroadcast(OP_DECODEMODE,0);
+    for(int row=0;row<8;row++)
+        forceBroadcast(row+1,0);
+    //we go into shutdown-mode on startup
+    forceBroadcast(OP_SHUTDOWN,0);
+}
+
+byte LedControl::shadowValue(byte opcode, byte data) {
+    //the bits the device ignores do not count
+    if(opcode==OP_INTENSITY)
+        return data & 0x0F;
+    if(opcode==OP_SCANLIMIT)
+        return data & 0x07;
+    if(opcode==OP_SHUTDOWN || opcode==OP_DISPLAYTEST)
+        return data & 0x01;
+    return data;
+}
+
+void LedControl::setShadow(int addr, byte opcode, byte data) {
+    data=shadowValue(opcode,data);
+    if(opcode>=OP_DIGIT0 && opcode<=OP_DIGIT7) {
+        status[addr*8+opcode-OP_DIGIT0]=data;
+        front[addr*8+opcode-OP_DIGIT0]=data;
+        dirty[addr]&=~(1 << (opcode-OP_DIGIT0));
+    }
+    else if(opcode==OP_DECODEMODE)
+        decodeMode[addr]=data;
+    else if(opcode==OP_INTENSITY)
+        intensity[addr]=data;
+    else if(opcode==OP_SCANLIMIT)
+        scanLimit[addr]=data;
+    else if(opcode==OP_SHUTDOWN) {
+        if(data)
+            flags[addr]|=FLAG_RUNNING;
+        else
+            flags[addr]&=~FLAG_RUNNING;
+    }
+    else if(opcode==OP_DISPLAYTEST) {
+        if(data)
+            flags[addr]|=FLAG_DISPLAYTEST;
+        else
+            flags[addr]&=~FLAG_DISPLAYTEST;
+    }
+}
+
+bool LedControl::isShadowed(int addr, byte opcode, byte data) {
+    data=shadowValue(opcode,data);
+    if(opcode>=OP_DIGIT0 && opcode<=OP_DIGIT7)
+        return front[addr*8+opcode-OP_DIGIT0]==data && status[addr*8+opcode-OP_DIGIT0]==data;
+    if(opcode==OP_DECODEMODE)
+        return decodeMode[addr]==data;
+    if(opcode==OP_INTENSITY)
+        return intensity[addr]==data;
+    if(opcode==OP_SCANLIMIT)
+        return scanLimit[addr]==data;
+    if(opcode==OP_SHUTDOWN)
+        return ((flags[addr] & FLAG_RUNNING)!=0)==data;
+    if(opcode==OP_DISPLAYTEST)
+        return ((flags[addr] & FLAG_DISPLAYTEST)!=0)==data;
+    return false;
+}
+
+void LedControl::writeRegister(int addr, byte opcode, byte data) {
+    if(isShadowed(addr,opcode,data)) {
+#ifdef LEDCONTROL_STATS
+        stats.elided++;
+#endif
+        return;
+    }
+    setShadow(addr,opcode,data);
+    spiTransfer(addr,opcode,data);
+}
+
+void LedControl::writeRegisterAll(byte opcode, byte data) {
+    bool send=false;
+
+    //devices that hold the value already get a no-op
+    clearFrame();
     for(int i=0;i<maxDevices;i++) {
-        spiTransfer(i,OP_DISPLAYTEST,0);
-        //scanlimit is set to max on startup
-        setScanLimit(i,7);
-        //decode is done in source
-        spiTransfer(i,OP_DECODEMODE,0);
-        clearDisplay(i);
-        //we go into shutdown-mode on startup
-        shutdown(i,true);
+        if(!isShadowed(i,opcode,data)) {
+            setShadow(i,opcode,data);
+            setFrame(i,opcode,data);
+            send=true;
+        }
+#ifdef LEDCONTROL_STATS
+        else
+            stats.elided++;
+#endif
     }
+    if(send)
+        sendFrame();
+}
+
+void LedControl::forceBroadcast(byte opcode, byte data) {
+    for(int i=0;i<maxDevices;i++)
+        setShadow(i,opcode,data);
+    spiBroadcast(opcode,data);
+}
+
+byte *LedControl::extraMemory() {
+    return memory+memorySize(maxDevices);
 }
 
 int LedControl::getDeviceCount() {
@@ -77,35 +336,397 @@ void LedControl::shutdown(int addr, bool b) {
     if(addr<0 || addr>=maxDevices)
         return;
     if(b)
-        spiTransfer(addr, OP_SHUTDOWN,0);
+        writeRegister(addr, OP_SHUTDOWN,0);
     else
-        spiTransfer(addr, OP_SHUTDOWN,1);
+        writeRegister(addr, OP_SHUTDOWN,1);
+}
+
+void LedControl::shutdownAll(bool b) {
+    if(b)
+        writeRegisterAll(OP_SHUTDOWN,0);
+    else
+        writeRegisterAll(OP_SHUTDOWN,1);
+}
+
+bool LedControl::isShutdown(int addr) {
+    if(addr<0 || addr>=maxDevices)
+        return false;
+    return !(flags[addr] & FLAG_RUNNING);
+}
+
+void LedControl::setDisplayTest(int addr, bool on) {
+    if(addr<0 || addr>=maxDevices)
+        return;
+    writeRegister(addr, OP_DISPLAYTEST,on ? 1 : 0);
+}
+
+bool LedControl::isDisplayTest(int addr) {
+    if(addr<0 || addr>=maxDevices)
+        return false;
+    return (flags[addr] & FLAG_DISPLAYTEST)!=0;
+}
+
+int LedControl::getDecodeMode(int addr) {
+    if(addr<0 || addr>=maxDevices)
+        return -1;
+    return decodeMode[addr];
+}
+
+void LedControl::setBuffered(bool enable) {
+    buffered=enable;
+    if(!buffered)
+        commit();
+}
+
+bool LedControl::isBuffered() {
+    return buffered;
+}
+
+void LedControl::commit() {
+    byte mask;
+    int offset;
+
+    //row by row over the whole chain, only rows the devices do not show yet
+    for(int row=0;row<8;row++) {
+        mask=1 << row;
+        clearFrame();
+        bool send=false;
+        for(int i=0;i<maxDevices;i++) {
+            if(dirty[i] & mask) {
+                dirty[i]&=~mask;
+                offset=i*8+row;
+                if(status[offset]!=front[offset]) {
+                    front[offset]=status[offset];
+                    setFrame(i, row+1,status[offset]);
+                    send=true;
+                }
+            }
+        }
+        if(send)
+            sendFrame();
+    }
+}
+
+void LedControl::markDevice(int addr) {
+    flags[addr]|=FLAG_MARKED;
+}
+
+void LedControl::commitMarked() {
+    byte mask;
+    int offset;
+
+    for(int row=0;row<8 && !buffered;row++) {
+        mask=1 << row;
+        clearFrame();
+        bool send=false;
+        for(int i=0;i<maxDevices;i++) {
+            if((flags[i] & FLAG_MARKED) && (dirty[i] & mask)) {
+                dirty[i]&=~mask;
+                offset=i*8+row;
+                if(status[offset]!=front[offset]) {
+                    front[offset]=status[offset];
+                    setFrame(i, row+1,status[offset]);
+                    send=true;
+                }
+            }
+        }
+        if(send)
+            sendFrame();
+    }
+    for(int i=0;i<maxDevices;i++)
+        flags[i]&=~FLAG_MARKED;
+}
+
+void LedControl::swap() {
+    buffered=true;
+    commit();
 }
 
 void LedControl::setScanLimit(int addr, int limit) {
     if(addr<0 || addr>=maxDevices)
         return;
     if(limit>=0 && limit<8)
-        spiTransfer(addr, OP_SCANLIMIT,limit);
+        writeRegister(addr, OP_SCANLIMIT,limit);
+}
+
+int LedControl::getScanLimit(int addr) {
+    if(addr<0 || addr>=maxDevices)
+        return -1;
+    return scanLimit[addr];
 }
 
 void LedControl::setIntensity(int addr, int intensity) {
     if(addr<0 || addr>=maxDevices)
         return;
-    if(intensity>=0 && intensity<16)	
-        spiTransfer(addr, OP_INTENSITY,intensity);
+    if(intensity>=0 && intensity<16) {
+        flags[addr]&=~(FLAG_FADING | FLAG_FADE_WAITING);
+        writeRegister(addr, OP_INTENSITY,intensity);
+    }
 }
 
-void LedControl::clearDisplay(int addr) {
-    int offset;
+int LedControl::getIntensity(int addr) {
+    if(addr<0 || addr>=maxDevices || intensity[addr]==INTENSITY_UNKNOWN)
+        return -1;
+    return intensity[addr];
+}
+
+void LedControl::setIntensityAll(int intensity) {
+    if(intensity>=0 && intensity<16) {
+        for(int i=0;i<maxDevices;i++)
+            flags[i]&=~(FLAG_FADING | FLAG_FADE_WAITING);
+        writeRegisterAll(OP_INTENSITY,intensity);
+    }
+}
 
+void LedControl::fadeTo(int addr, int intensity, uint32_t duration) {
     if(addr<0 || addr>=maxDevices)
         return;
-    offset=addr*8;
-    for(int i=0;i<8;i++) {
-        status[offset+i]=0;
-        spiTransfer(addr, i+1,status[offset+i]);
+    if(intensity<0 || intensity>15)
+        return;
+    //a device we never set the intensity of is at 0 after power-up
+    fadeFrom[addr]=this->intensity[addr]==INTENSITY_UNKNOWN ? 0 : this->intensity[addr];
+    fadeTarget[addr]=intensity;
+    fadeTime[addr]=duration;
+    //the fade starts with the next updateFade()
+    flags[addr]|=FLAG_FADING | FLAG_FADE_WAITING;
+    fading=true;
+}
+
+void LedControl::fadeAllTo(int intensity, uint32_t duration) {
+    for(int i=0;i<maxDevices;i++)
+        fadeTo(i,intensity,duration);
+}
+
+bool LedControl::updateFade(uint32_t ms) {
+    bool send=false;
+
+    if(!fading)
+        return true;
+    fading=false;
+    clearFrame();
+    for(int i=0;i<maxDevices;i++) {
+        byte level;
+
+        if(!(flags[i] & FLAG_FADING))
+            continue;
+        if(flags[i] & FLAG_FADE_WAITING) {
+            flags[i]&=~FLAG_FADE_WAITING;
+            fadeStart[i]=ms;
+        }
+        uint32_t elapsed=ms-fadeStart[i];
+        uint32_t duration=fadeTime[i];
+        if(elapsed>=duration) {
+            level=fadeTarget[i];
+            flags[i]&=~FLAG_FADING;
+        }
+        else {
+            fading=true;
+            //the lightness goes linear in time, the nearest intensity is used
+            while(duration>0xFFFFFFUL) {
+                duration>>=1;
+                elapsed>>=1;
+            }
+            int from=pgm_read_byte(lightnessTable+fadeFrom[i]);
+            int to=pgm_read_byte(lightnessTable+fadeTarget[i]);
+            int lightness=from+(int)((to-from)*(long)((elapsed << 8)/duration) >> 8);
+            int best=256;
+            level=0;
+            for(int l=0;l<16;l++) {
+                int d=lightness-pgm_read_byte(lightnessTable+l);
+                if(d<0)
+                    d=-d;
+                if(d<best) {
+                    best=d;
+                    level=l;
+                }
+            }
+        }
+        if(level!=intensity[i]) {
+#ifdef LEDCONTROL_STATS
+            //the levels between the last one sent and this one were never shown
+            if(intensity[i]!=INTENSITY_UNKNOWN)
+                stats.stepsDropped+=abs(level-intensity[i])-1;
+#endif
+            intensity[i]=level;
+            setFrame(i,OP_INTENSITY,level);
+            send=true;
+        }
+    }
+    //devices without a new step get a no-op in the same transfer
+    if(send)
+        sendFrame();
+    return !fading;
+}
+
+bool LedControl::isFading() {
+    return fading;
+}
+
+void LedControl::resync() {
+    resyncStep=0;
+}
+
+void LedControl::setAutoResync(uint32_t interval) {
+    resyncInterval=interval;
+}
+
+bool LedControl::updateResync(uint32_t ms) {
+    bool send=false;
+    byte opcode;
+
+    if(resyncStep==RESYNC_IDLE) {
+        if(!resyncInterval || ms-resyncStart<resyncInterval)
+            return true;
+        resyncStep=0;
+    }
+    if(resyncStep==0)
+        resyncStart=ms;
+    //the rows come before the end of the shutdown, so a device never
+    //shows garbage once it is switched on again
+    switch(resyncStep) {
+        case 0:  opcode=OP_DISPLAYTEST; break;
+        case 1:  opcode=OP_SCANLIMIT;   break;
+        case 2:  opcode=OP_DECODEMODE;  break;
+        case 3:  opcode=OP_INTENSITY;   break;
+        case 12: opcode=OP_SHUTDOWN;    break;
+        default: opcode=OP_DIGIT0+resyncStep-4; break;
+    }
+    clearFrame();
+    for(int i=0;i<maxDevices;i++) {
+        byte data;
+        if(opcode>=OP_DIGIT0 && opcode<=OP_DIGIT7) {
+            //what the device should show, pending rows are left to commit()
+            data=front[i*8+opcode-OP_DIGIT0];
+        }
+        else if(opcode==OP_DISPLAYTEST)
+            data=(flags[i] & FLAG_DISPLAYTEST) ? 1 : 0;
+        else if(opcode==OP_SCANLIMIT)
+            data=scanLimit[i];
+        else if(opcode==OP_DECODEMODE)
+            data=decodeMode[i];
+        else if(opcode==OP_INTENSITY) {
+            if(intensity[i]==INTENSITY_UNKNOWN)
+                continue;
+            data=intensity[i];
+        }
+        else
+            data=(flags[i] & FLAG_RUNNING) ? 1 : 0;
+        setFrame(i,opcode,data);
+        send=true;
+    }
+    if(send)
+        sendFrame();
+    if(++resyncStep>=RESYNC_FRAMES) {
+        resyncStep=RESYNC_IDLE;
+        return true;
+    }
+    return false;
+}
+
+void LedControl::play(const byte *stream, bool progmem) {
+    this->stream=stream;
+    streamPos=stream;
+    streamProgmem=progmem;
+    streamWaiting=false;
+}
+
+void LedControl::stopStream() {
+    stream=NULL;
+}
+
+bool LedControl::isPlaying() {
+    return stream!=NULL;
+}
+
+byte LedControl::streamByte() {
+    byte b=streamProgmem ? pgm_read_byte(streamPos) : *streamPos;
+    streamPos++;
+    return b;
+}
+
+bool LedControl::updateStream(uint32_t ms) {
+    byte opcode,count,addr,data;
+    bool repeated=false;
+
+    if(!stream)
+        return true;
+    if(streamWaiting) {
+        if(ms-streamStart<streamWait)
+            return false;
+#ifdef LEDCONTROL_STATS
+        countStep(ms-streamStart-streamWait);
+#endif
+        streamWaiting=false;
+    }
+    //everything up to the next wait is due now
+    while(stream) {
+        opcode=streamByte();
+        if(opcode==LED_STREAM_WAIT) {
+            streamWait=streamByte();
+            streamWait|=(uint16_t)streamByte() << 8;
+            streamStart=ms;
+            streamWaiting=true;
+            return false;
+        }
+        if(opcode==LED_STREAM_REPEAT) {
+            streamPos=stream;
+            //a stream without a wait would never give the loop back
+            if(repeated)
+                return false;
+            repeated=true;
+            continue;
+        }
+        if(opcode==0 || opcode>OP_DISPLAYTEST) {
+            stream=NULL;
+            break;
+        }
+        //one record is one frame, nothing is left out
+        count=streamByte();
+        clearFrame();
+        bool send=false;
+        for(int i=0;i<count;i++) {
+            addr=streamByte();
+            data=streamByte();
+            if(addr<maxDevices) {
+                setShadow(addr,opcode,data);
+                setFrame(addr,opcode,data);
+                send=true;
+            }
+        }
+        if(send)
+            sendFrame();
     }
+    return true;
+}
+
+bool LedControl::update(uint32_t ms) {
+    bool done=true;
+
+    //a resync runs in the background, nobody has to wait for it
+    updateResync(ms);
+    done=updateStream(ms);
+    if(!updateFade(ms))
+        done=false;
+    return done;
+}
+
+void LedControl::clearAll() {
+    if(buffered) {
+        for(int i=0;i<maxDevices;i++)
+            clearDisplay(i);
+        return;
+    }
+    //one transfer per row, devices where the row is dark already get a no-op
+    for(int row=0;row<8;row++)
+        writeRegisterAll(row+1,0);
+}
+
+void LedControl::clearDisplay(int addr) {
+    if(addr<0 || addr>=maxDevices)
+        return;
+    //rows that are dark already are not sent again
+    for(int i=0;i<8;i++)
+        updateRow(addr,i,0);
 }
 
 void LedControl::setLed(int addr, int row, int column, boolean state) {
@@ -119,64 +740,120 @@ void LedControl::setLed(int addr, int row, int column, boolean state) {
     offset=addr*8;
     val=B10000000 >> column;
     if(state)
-        status[offset+row]=status[offset+row]|val;
+        val=status[offset+row]|val;
     else {
         val=~val;
-        status[offset+row]=status[offset+row]&val;
+        val=status[offset+row]&val;
     }
-    spiTransfer(addr, row+1,status[offset+row]);
+    updateRow(addr,row,val);
 }
 
 void LedControl::setRow(int addr, int row, byte value) {
-    int offset;
     if(addr<0 || addr>=maxDevices)
         return;
     if(row<0 || row>7)
         return;
-    offset=addr*8;
-    status[offset+row]=value;
-    spiTransfer(addr, row+1,status[offset+row]);
+    updateRow(addr,row,value);
 }
 
-void LedControl::setColumn(int addr, int col, byte value) {
-    byte val;
+byte LedControl::getRow(int addr, int row) {
+    if(addr<0 || addr>=maxDevices)
+        return 0;
+    if(row<0 || row>7)
+        return 0;
+    return status[addr*8+row];
+}
 
+void LedControl::setColumn(int addr, int col, byte value) {
     if(addr<0 || addr>=maxDevices)
         return;
     if(col<0 || col>7) 
         return;
+    writeColumns(addr,B10000000 >> col,value);
+    autoFlush(addr);
+}
+
+void LedControl::writeColumns(int addr, byte mask, byte value) {
+    int offset;
+    byte val;
+
+    if(addr<0 || addr>=maxDevices)
+        return;
+    offset=addr*8;
+    //bit 7 of the value is row 0, the masked columns of a row are all
+    //set or all cleared
     for(int row=0;row<8;row++) {
-        val=value >> (7-row);
-        val=val & 0x01;
-        setLed(addr,row,col,val);
+        val=status[offset+row] & ~mask;
+        if(value & B10000000)
+            val|=mask;
+        value<<=1;
+        if(val!=status[offset+row]) {
+            status[offset+row]=val;
+            dirty[addr]|=1 << row;
+        }
     }
 }
 
-void LedControl::setDigit(int addr, int digit, byte value, boolean dp) {
+void LedControl::autoFlush(int addr) {
+    if(!buffered)
+        flush(addr);
+}
+
+void LedControl::autoCommit() {
+    if(!buffered)
+        commit();
+}
+
+void LedControl::updateRow(int addr, int row, byte value) {
+    int offset=addr*8;
+
+    if(buffered) {
+        if(status[offset+row]!=value) {
+            status[offset+row]=value;
+            dirty[addr]|=1 << row;
+        }
+        return;
+    }
+    writeRegister(addr, row+1,value);
+}
+
+void LedControl::flush(int addr) {
     int offset;
+
+    if(addr<0 || addr>=maxDevices)
+        return;
+    offset=addr*8;
+    for(int row=0;row<8 && dirty[addr];row++) {
+        if(dirty[addr] & (1 << row)) {
+            dirty[addr]&=~(1 << row);
+            if(status[offset+row]!=front[offset+row]) {
+                front[offset+row]=status[offset+row];
+                spiTransfer(addr, row+1,status[offset+row]);
+            }
+        }
+    }
+}
+
+void LedControl::setDigit(int addr, int digit, byte value, boolean dp) {
     byte v;
 
     if(addr<0 || addr>=maxDevices)
         return;
     if(digit<0 || digit>7 || value>15)
         return;
-    offset=addr*8;
     v=pgm_read_byte_near(charTable + value); 
     if(dp)
         v|=B10000000;
-    status[offset+digit]=v;
-    spiTransfer(addr, digit+1,v);
+    updateRow(addr,digit,v);
 }
 
 void LedControl::setChar(int addr, int digit, char value, boolean dp) {
-    int offset;
     byte index,v;
 
     if(addr<0 || addr>=maxDevices)
         return;
     if(digit<0 || digit>7)
         return;
-    offset=addr*8;
     index=(byte)value;
     if(index >127) {
         //no defined beyond index 127, so we use the space char
@@ -185,99 +862,461 @@ void LedControl::setChar(int addr, int digit, char value, boolean dp) {
     v=pgm_read_byte_near(charTable + index); 
     if(dp)
         v|=B10000000;
-    status[offset+digit]=v;
-    spiTransfer(addr, digit+1,v);
+    updateRow(addr,digit,v);
+}
+
+void LedControl::spiTransferAll(byte opcode, const byte *data) {
+    for(int i=0;i<maxDevices;i++) {
+        setShadow(i,opcode,data[i]);
+        setFrame(i,opcode,data[i]);
+    }
+    sendFrame();
 }
 
 void LedControl::spiTransfer(int addr, volatile byte opcode, volatile byte data) {
     //Create an array with the data to shift out
-    int offset=addr*2;
+    clearFrame();
+    //put our device data into the array
+    setFrame(addr,opcode,data);
+    sendFrame();
+}    
+
+void LedControl::spiBroadcast(byte opcode, byte data) {
+    for(int i=0;i<maxDevices;i++)
+        setFrame(i,opcode,data);
+    sendFrame();
+}
+
+void LedControl::clearFrame() {
     int maxbytes=maxDevices*2;
 
+    //the devices we don't talk to get an OP_NOOP
     for(int i=0;i<maxbytes;i++)
         spidata[i]=(byte)0;
-    //put our device data into the array
-    spidata[offset+1]=opcode;
-    spidata[offset]=data;
-    //enable the line 
-    digitalWrite(SPI_CS,LOW);
-    //Now shift out the data 
-    for(int i=maxbytes;i>0;i--)
-        shiftOut(SPI_MOSI,SPI_CLK,MSBFIRST,spidata[i-1]);
-    //latch the data onto the display
-    digitalWrite(SPI_CS,HIGH);
-}    
+}
 
-LedControlDC::LedControlDC(int dataPin, int clkPin, int csPin, int numDevices):
-LedControl(dataPin,clkPin,csPin,numDevices){
-  memset(_buffer_r,'\0',4);
-  memset(_buffer_g,'\0',4);
+void LedControl::setFrame(int addr, byte opcode, byte data) {
+    //the last device on the chain is shifted out first
+    int offset=(maxDevices-1-addr)*2;
+
+    spidata[offset]=opcode;
+    spidata[offset+1]=data;
+}
+
+void LedControl::sendFrame() {
+    if(queue) {
+        for(int i=0;i<maxDevices;i++) {
+            int offset=(maxDevices-1-i)*2;
+            if(spidata[offset]!=OP_NOOP)
+                enqueue(i,spidata[offset],spidata[offset+1]);
+        }
+        return;
+    }
+    transferFrame(spidata);
+}
+
+void LedControl::transferFrame(const byte *data) {
+#ifdef LEDCONTROL_STATS
+    unsigned long start=micros();
+#endif
+    if(transport)
+        transport->transfer(data,maxDevices*2);
+#ifdef LEDCONTROL_STATS
+    unsigned long time=micros()-start;
+    stats.frames++;
+    stats.bytes+=maxDevices*2;
+    stats.busMicros+=time;
+    if(time>stats.maxMicros)
+        stats.maxMicros=time;
+    if(frameHook)
+        frameHook(data,maxDevices*2,time,frameHookContext);
+#endif
+}
+
+#ifdef LEDCONTROL_STATS
+const LedStats &LedControl::getStats() {
+    return stats;
+}
+
+void LedControl::resetStats() {
+    memset(&stats,0,sizeof(stats));
+}
+
+void LedControl::setFrameHook(LedFrameHook hook, void *context) {
+    frameHook=hook;
+    frameHookContext=context;
+}
+
+void LedControl::countStep(uint32_t late) {
+    if(late>0 && late<0x80000000UL) {
+        stats.stepsLate++;
+        if(late>stats.maxLateMillis)
+            stats.maxLateMillis=late;
+    }
+}
+#endif
+
+void LedControl::setQueue(LedQueueOp *buffer, int size) {
+    if(!buffer || size<2)
+        buffer=NULL;
+    if(size>255)
+        size=255;
+    //send what is waiting with interrupts on, a timer interrupt may
+    //send some of it as well
+    while(!service(8));
+    //it must not see the old buffer with the new indices
+    uint8_t sreg=lockQueue();
+    queue=NULL;
+    queueHead=0;
+    queueTail=0;
+    queueSize=size;
+    queue=buffer;
+    unlockQueue(sreg);
 }
 
-void LedControlDC::_setValueRed(int addr, int digit, uint8_t img){
+void LedControl::enqueue(byte addr, byte opcode, byte data) {
+    byte head=queueHead;
+    int last=-1;
+
+    //the newest write of the register that is still waiting
+    for(byte i=queueTail;i!=head;i=(i+1)%queueSize) {
+        if(queue[i].addr==addr && queue[i].opcode==opcode)
+            last=i;
+    }
+    if(last>=0) {
+        queue[last].data=data;
+        //service() can not stop halfway (it runs in an interrupt or
+        //in our own context), if the write is still waiting after
+        //we changed it the new value will be sent
+        byte tail=queueTail;
+        if((byte)((last+queueSize-tail)%queueSize) < (byte)((head+queueSize-tail)%queueSize)) {
+#ifdef LEDCONTROL_STATS
+            stats.elided++;
+#endif
+            return;
+        }
+    }
+    byte next=(head+1)%queueSize;
+    //the queue is full, send a frame ourselves. Interrupts stay on, a
+    //timer interrupt that comes meanwhile finds service() busy
+    while(next==queueTail)
+        service(1);
+    queue[head].addr=addr;
+    queue[head].opcode=opcode;
+    queue[head].data=data;
+    queueHead=next;
+}
+
+bool LedControl::service(int maxFrames) {
+    if(!queue)
+        return true;
+    //one service() at a time, the other one (in loop() or in a timer
+    //interrupt) returns at once. Only the flag needs interrupts off, the
+    //frames go out with them on
+    uint8_t sreg=lockQueue();
+    bool busy=queueBusy;
+    queueBusy=true;
+    unlockQueue(sreg);
+    if(busy)
+        return false;
+    for(int f=0;f<maxFrames && queueTail!=queueHead;f++) {
+        for(int i=0;i<maxDevices*2;i++)
+            queueData[i]=OP_NOOP;
+        //take writes until a device comes a second time, the order of 
+        //the writes to each device stays the same
+        while(queueTail!=queueHead) {
+            byte tail=queueTail;
+            int offset=(maxDevices-1-queue[tail].addr)*2;
+            //a queued write is never a no-op
+            if(queueData[offset]!=OP_NOOP)
+                break;
+            queueData[offset]=queue[tail].opcode;
+            queueData[offset+1]=queue[tail].data;
+            queueTail=(tail+1)%queueSize;
+        }
+        transferFrame(queueData);
+    }
+    queueBusy=false;
+    return queueTail==queueHead;
+}
+
+int LedControl::getQueueCount() {
+    if(!queue)
+        return 0;
+    return (queueHead+queueSize-queueTail)%queueSize;
+}
+
+LedControlDC::LedControlDC(int dataPin, int clkPin, int csPin, int numDevices, const DCLayout &layout):
+LedControl(dataPin,clkPin,csPin,numDevices,NULL,DEVICE_SIZE){
+  _init(layout);
+}
+
+LedControlDC::LedControlDC(LedTransport &transport, int numDevices, const DCLayout &layout):
+LedControl(transport,numDevices,NULL,DEVICE_SIZE){
+  _init(layout);
+}
+
+LedControlDC::LedControlDC(int dataPin, int clkPin, int csPin, int numDevices, const DCLayout &layout, byte *memory):
+LedControl(dataPin,clkPin,csPin,numDevices,memory,DEVICE_SIZE){
+  _init(layout);
+}
+
+LedControlDC::LedControlDC(LedTransport &transport, int numDevices, const DCLayout &layout, byte *memory):
+LedControl(transport,numDevices,memory,DEVICE_SIZE){
+  _init(layout);
+}
+
+void LedControlDC::_init(const DCLayout &layout){
+  int n = getDeviceCount();
+  _buffer_r  = extraMemory();
+  _buffer_g  = _buffer_r + n*4;
+  _blend     = _buffer_g + n*4;
+  _blend_acc = _blend + n;
+  _blend_red = _blend_acc + n;
+  _blink     = _blend_red + n;
+  memset(_buffer_r,'\0',DEVICE_SIZE*n);
+  _blink_off  = false;
+  _blink_wait = false;
+  _blink_tm   = 0;
+  _layout = &layout;
+  _font = &DC_FONT_DEFAULT;
+  _anim = DCAnimation();
+  _scroll_active = false;
+  _scroll_wait   = false;
+  _scroll_repeat = false;
+  _scroll_color  = DC_NONE;
+}
+
+void LedControlDC::_setValue(int addr, int digit, uint8_t img_r, uint8_t img_g){
+  if( addr <0 || addr >= getDeviceCount() )return;
   if( digit <0 || digit >= 4 )return;
-  uint8_t d = 1;
-  switch( digit ){
-    case 0:  d = 1; break;
-    case 1:  d = 2; break;
-    case 2:  d = 3; break;
-    default: d = 4; break;
+  _buffer_r[addr*4+digit] = img_r;  
+  _buffer_g[addr*4+digit] = img_g;  
+  _showValue(addr,digit);
+}
+
+void LedControlDC::_showValue(int addr, int digit){
+  uint8_t img_r = _buffer_r[addr*4+digit];
+  uint8_t img_g = _buffer_g[addr*4+digit];
+// A blended orange digit (the same image in both colors) shows only the color
+// of this tick. A digit with two different images is not orange, it stays as it is
+  if( _blend[addr] && img_r && img_r == img_g ){
+    if( _blend_red[addr] )img_g = 0;
+    else img_r = 0;
+  }
+// A blinking digit is dark in the off phase, its images stay
+  if( _blink_off && (_blink[addr] & (1 << digit)) )img_r = img_g = 0;
+  uint8_t r = _layout->red[digit];
+  uint8_t g = _layout->green[digit];
+// Same image in both colors (orange) is one pass over the rows
+  if( img_r == img_g )LedControl::writeColumns(addr,r|g,img_r);
+  else {
+    LedControl::writeColumns(addr,r,img_r);
+    LedControl::writeColumns(addr,g,img_g);
   }
-  LedControl::setColumn(0,d,img);   
-  _buffer_r[digit] = img;  
 }
 
-void LedControlDC::_setValueGreen(int addr, int digit, uint8_t img){
-  if( digit <0 || digit >= 4 )return;
-  uint8_t d = 1;
-  switch( digit ){
-    case 0:  d = 5; break;
-    case 1:  d = 6; break;
-    case 2:  d = 7; break;
-    default: d = 0; break;
+void LedControlDC::_showDevice(int addr){
+  for( int i=0; i<4; i++ )_showValue(addr,i);
+}
+
+void LedControlDC::setBlend(int addr, uint8_t red){
+  if( addr <0 || addr >= getDeviceCount() )return;
+  if( red >= 16 )red = 0;
+  _blend[addr]     = red;
+  _blend_acc[addr] = 0;
+  _blend_red[addr] = 0;
+  _showDevice(addr);
+  autoFlush(addr);
+}
+
+uint8_t LedControlDC::getBlend(int addr){
+  if( addr <0 || addr >= getDeviceCount() )return 0;
+  return _blend[addr];
+}
+
+void LedControlDC::tick(){
+  bool changed = false;
+  for( int addr=0; addr<getDeviceCount(); addr++ ){
+    if( !_blend[addr] )continue;
+// Bresenham: red in exactly red of every 16 ticks, spread as evenly as possible
+    uint8_t red = 0;
+    _blend_acc[addr] += _blend[addr];
+    if( _blend_acc[addr] >= 16 ){
+      _blend_acc[addr] -= 16;
+      red = 1;
+    }
+    if( red == _blend_red[addr] )continue;
+    _blend_red[addr] = red;
+    _showDevice(addr);
+    markDevice(addr);
+    changed = true;
+  }
+// Only the rows of the switched devices, all of them together. In buffered mode
+// they wait for commit()
+  if( changed )commitMarked();
+}
+
+#define BULK_CLEAR  0
+#define BULK_FILL   1
+#define BULK_INVERT 2
+#define BULK_SWAP   3
+
+// op on the images of addr, all devices for addr -1
+void LedControlDC::_bulk(int addr, uint8_t op, DC_COLOR color){
+  int first = addr, last = addr;
+  if( addr < 0 ){
+    first = 0;
+    last  = getDeviceCount()-1;
+  }
+  else if( addr >= getDeviceCount() )return;
+  for( int a=first; a<=last; a++ ){
+    uint8_t *r = _buffer_r + a*4;
+    uint8_t *g = _buffer_g + a*4;
+    for( int i=0; i<4; i++ ){
+      uint8_t t;
+      switch(op){
+        case BULK_CLEAR:  r[i] = g[i] = 0; break;
+        case BULK_FILL:
+          r[i] = (color & DC_RED) ? 0xFF : 0;
+          g[i] = (color & DC_GREEN) ? 0xFF : 0;
+          break;
+        case BULK_INVERT: r[i] = ~r[i]; g[i] = ~g[i]; break;
+        default:          t = r[i]; r[i] = g[i]; g[i] = t; break;
+      }
+    }
+// Columns outside the layout go dark too, like clearDisplay()
+    if( op == BULK_CLEAR )LedControl::writeColumns(a,0xFF,0);
+    else _showDevice(a);
+  }
+// One device: its changed rows. The chain: one transfer per changed row
+  if( addr < 0 )autoCommit();
+  else autoFlush(addr);
+}
+
+void LedControlDC::clear(int addr){
+  if( addr <0 )return;
+  _bulk(addr,BULK_CLEAR,DC_NONE);
+}
+
+void LedControlDC::clear(){
+  _bulk(-1,BULK_CLEAR,DC_NONE);
+}
+
+void LedControlDC::fill(int addr, DC_COLOR color){
+  if( addr <0 )return;
+  _bulk(addr,BULK_FILL,color);
+}
+
+void LedControlDC::fill(DC_COLOR color){
+  _bulk(-1,BULK_FILL,color);
+}
+
+void LedControlDC::invert(int addr){
+  if( addr <0 )return;
+  _bulk(addr,BULK_INVERT,DC_NONE);
+}
+
+void LedControlDC::invert(){
+  _bulk(-1,BULK_INVERT,DC_NONE);
+}
+
+void LedControlDC::swapColors(int addr){
+  if( addr <0 )return;
+  _bulk(addr,BULK_SWAP,DC_NONE);
+}
+
+void LedControlDC::swapColors(){
+  _bulk(-1,BULK_SWAP,DC_NONE);
+}
+
+void LedControlDC::clearDisplay(int addr){
+  clear(addr);
+}
+
+void LedControlDC::clearAll(){
+  clear();
+}
+
+void LedControlDC::blink(int addr, uint8_t digits, uint16_t tm){
+  if( addr <0 || addr >= getDeviceCount() )return;
+  _blink[addr] = digits & 0x0F;
+  bool any = false;
+  for( int i=0; i<getDeviceCount(); i++ )
+    if( _blink[i] )any = true;
+  if( !any )_blink_tm = 0;
+  else {
+// The first blinking digits start in the on phase
+    if( !_blink_tm ){
+      _blink_off  = false;
+      _blink_wait = false;
+    }
+    _blink_tm = tm ? tm : 1;
   }
-   LedControl::setColumn(0,d,img);   
-   _buffer_g[digit] = img;  
+  if( !_blink_tm )_blink_off = false;
+  _showDevice(addr);
+  autoFlush(addr);
+}
+
+uint8_t LedControlDC::getBlink(int addr){
+  if( addr <0 || addr >= getDeviceCount() )return 0;
+  return _blink[addr];
+}
+
+void LedControlDC::_updateBlink(uint32_t ms){
+  if( _blink_wait && (uint32_t)(ms-_blink_ms) < _blink_tm )return;
+  _blink_ms = ms;
+  if( !_blink_wait ){
+    _blink_wait = true;
+    return;
+  }
+  _blink_off = !_blink_off;
+  for( int addr=0; addr<getDeviceCount(); addr++ ){
+    if( !_blink[addr] )continue;
+    _showDevice(addr);
+    markDevice(addr);
+  }
+// Like tick(): only the rows of the blinking devices, all of them together
+  commitMarked();
 }
 
 uint8_t LedControlDC::_valueToImg(char value,boolean dp ){
-   uint8_t z = pgm_read_byte(&characterArrayDC[value]); 
+   uint8_t z = getGlyph(value); 
    if( dp )z |= 0b00000001; 
    return z; 
 }
 
+void LedControlDC::setFont(const DCFont &font){
+  _font = &font;
+}
+
+const DCFont &LedControlDC::getFont(){
+  return *_font;
+}
+
+uint8_t LedControlDC::getGlyph(char value){
+  uint8_t code = (uint8_t)value;
+  for( const DCFont *f = _font; f; f = f->next ){
+    if( code >= f->first && code - f->first < f->count )
+      return pgm_read_byte(f->glyphs + (code - f->first));
+  }
+  return _font->fallback;
+}
+
 void LedControlDC::setChar(int addr, int digit, char value, boolean dp, DC_COLOR color){
   if( digit <0 || digit >= 4 )return;
   uint8_t z = _valueToImg(value,dp);
-  if( color & DC_RED )_setValueRed(addr, digit, z);
-  else _setValueRed(addr, digit, 0); 
-  if( color & DC_GREEN )_setValueGreen(addr, digit, z);
-  else _setValueGreen(addr, digit, 0);
+  _setValue(addr, digit, (color & DC_RED) ? z : 0, (color & DC_GREEN) ? z : 0);
+  autoFlush(addr);
 }
 
 void LedControlDC::setCharDC(int addr, int digit, char value_r, boolean dp_r,char value_g, boolean dp_g ){
    if( digit >=4 )return;
-   _setValueRed(addr, digit, _valueToImg(value_r,dp_r));
-   _setValueGreen(addr, digit, _valueToImg(value_g,dp_g));
+   _setValue(addr, digit, _valueToImg(value_r,dp_r), _valueToImg(value_g,dp_g));
+   autoFlush(addr);
 }
 
-void LedControlDC::clearAnimation(int addr, uint16_t tm){
-  uint8_t mask_array[] = {0b11110011,0b01100001,0b00000000};
-  for( int i=0; i<4; i++ ){
-    for( int j=0; j<3; j++ ){
-      uint8_t mask;
-      if( i == 2 )mask = mask_array[j]&0b11111110;
-      else mask = mask_array[j];
-      _setValueRed(addr,i,_buffer_r[i]&mask);
-      _setValueGreen(addr,i,_buffer_g[i]&mask);
-      delay(tm);
-    }
-  }
-}
-
-void LedControlDC::printAnimation(int addr, char v1, char v2, char v3,char v4, boolean dp, DC_COLOR color,uint16_t tm){
-  uint8_t mask_array[] = {0b00001100,0b10011111,0b11111111};
-  uint8_t img_r,img_g;
+void LedControlDC::_valuesToImg(char v1, char v2, char v3,char v4, boolean dp, DC_COLOR color, const DC_COLOR *colors, uint8_t *img_r, uint8_t *img_g){
   char value1;
   bool dp1;
   for( int i=0; i<4; i++ ){
@@ -287,38 +1326,321 @@ void LedControlDC::printAnimation(int addr, char v1, char v2, char v3,char v4, b
       case 2:  value1 = v3; dp1 = dp;    break;
       default: value1 = v4; dp1 = false; break;
     }  
-    if( color & DC_RED )img_r = _valueToImg(value1,dp1);
-    else img_r = 0; 
-    if( color & DC_GREEN )img_g = _valueToImg(value1,dp1);
-    else img_g = 0;       
-    for( int j=0; j<3; j++ ){
-      uint8_t mask;
-       if( i == 2 )mask = mask_array[j]&0b11111111;
-       else mask = mask_array[j];
-      _setValueRed(addr,i,img_r&mask);
-      _setValueGreen(addr,i,img_g&mask);
-      delay(tm);
+    if( colors )color = colors[i];
+    if( color & DC_RED )img_r[i] = _valueToImg(value1,dp1);
+    else img_r[i] = 0; 
+    if( color & DC_GREEN )img_g[i] = _valueToImg(value1,dp1);
+    else img_g[i] = 0;       
+  }
+}
+
+void LedControlDC::_animationStep(DCAnimation &anim){
+  DCStep st;
+  st.ticks = 0;
+  do {
+    if( _animationDone(anim) )break;
+    memcpy_P(&st,anim.trans->steps+anim.step,sizeof(st));
+    anim.step++;
+    for( int i=0; i<4; i++ ){
+      if( !(st.digits & (1 << i)) )continue;
+// Digit of the old and of the new image shown on digit i, -1 for none
+      int o = i, n = i;
+      if( st.op == DC_STEP_SLIDE_LEFT ){
+        if( i + st.arg < 4 ){ o = i + st.arg; n = -1; }
+        else { o = -1; n = i + st.arg - 4; }
+      }
+      else if( st.op == DC_STEP_SLIDE_RIGHT ){
+        if( i < st.arg ){ o = -1; n = i + 4 - st.arg; }
+        else { o = i - st.arg; n = -1; }
+      }
+      uint8_t img_r = 0, img_g = 0;
+      if( o >= 0 ){
+        img_r |= anim.rOld[o] & st.rOld;
+        img_g |= anim.gOld[o] & st.gOld;
+      }
+      if( n >= 0 ){
+        img_r |= anim.rNew[n] & st.rNew;
+        img_g |= anim.gNew[n] & st.gNew;
+      }
+      _setValue(anim.addr,i,img_r,img_g);
     }
+  } while( st.ticks == 0 );
+  anim.ticks = st.ticks;
+// In buffered mode the step waits for commit() or swap() with the rest of the page
+  autoFlush(anim.addr);
+}
+
+bool LedControlDC::_animationDone(DCAnimation &anim){
+  while( anim.trans && anim.step >= anim.trans->count ){
+    anim.trans = anim.trans->next;
+    anim.step  = 0;
+  }
+  return anim.trans == NULL;
+}
+
+void LedControlDC::_runAnimation(DCAnimation &anim){
+// It takes the place of the animation update() runs, like it always did
+  _anim.active = false;
+  while( !_animationDone(anim) ){
+    _animationStep(anim);
+    delay((uint32_t)anim.tm*anim.ticks);
+  }
+  anim.active = false;
+}
+
+void LedControlDC::_startAnimation(DCAnimation &anim, int addr, const DCTransition &transition, uint16_t tm){
+  if( addr <0 || addr >= getDeviceCount() )return;
+  memcpy(anim.rOld,_buffer_r+addr*4,4);
+  memcpy(anim.gOld,_buffer_g+addr*4,4);
+  anim.addr   = addr;
+  anim.trans  = &transition;
+  anim.tm     = tm;
+  anim.step   = 0;
+  anim.ticks  = 0;
+  anim.active = true;
+  anim.wait   = false;
+}
+
+void LedControlDC::startClearAnimation(int addr, uint16_t tm){
+  _startAnimation(_anim,addr,DC_TRANSITION_CLEAR,tm);
+}
+
+void LedControlDC::startPrintAnimation(int addr, char v1, char v2, char v3,char v4, boolean dp, DC_COLOR color,uint16_t tm, boolean clear){
+  startTransition(addr,clear?DC_TRANSITION_CLEAR_PRINT:DC_TRANSITION_PRINT,v1,v2,v3,v4,dp,color,tm);
+}
+
+void LedControlDC::startTransition(int addr, const DCTransition &transition, char v1, char v2, char v3,char v4, boolean dp, DC_COLOR color, uint16_t tm){
+  _valuesToImg(v1,v2,v3,v4,dp,color,NULL,_anim.rNew,_anim.gNew);
+  _startAnimation(_anim,addr,transition,tm);
+}
+
+bool LedControlDC::isAnimating(){
+  return _anim.active;
+}
+
+bool LedControlDC::update(uint32_t ms){
+  bool done = true;
+  done = _updateAnimation(ms);
+  if( !LedControl::update(ms) )done = false;
+  if( _scroll_active ){
+    _updateScroll(ms);
+    done = false;
+  }
+  if( _blink_tm ){
+    _updateBlink(ms);
+    done = false;
+  }
+  return done;
+}
+
+bool LedControlDC::_updateAnimation(uint32_t ms){
+  if( !_anim.active )return true;
+// Each step stays on the display for its ticks, the last one too
+  if( _anim.wait && (uint32_t)(ms-_anim.ms) < (uint32_t)_anim.tm*_anim.ticks )return false;
+  if( _animationDone(_anim) ){
+    _anim.active = false;
+    return true;
   }
+#ifdef LEDCONTROL_STATS
+  if( _anim.wait )countStep(ms-_anim.ms-(uint32_t)_anim.tm*_anim.ticks);
+#endif
+  _animationStep(_anim);
+  _anim.ms   = ms;
+  _anim.wait = true;
+  return false;
+}
+
+void LedControlDC::clearAnimation(int addr, uint16_t tm){
+  DCAnimation anim = {};
+  _startAnimation(anim,addr,DC_TRANSITION_CLEAR,tm);
+  _runAnimation(anim);
+}
+
+void LedControlDC::printAnimation(int addr, char v1, char v2, char v3,char v4, boolean dp, DC_COLOR color,uint16_t tm){
+  DCAnimation anim = {};
+  _valuesToImg(v1,v2,v3,v4,dp,color,NULL,anim.rNew,anim.gNew);
+  _startAnimation(anim,addr,DC_TRANSITION_PRINT,tm);
+  _runAnimation(anim);
 }
 
 void LedControlDC::print(int addr, char v1, char v2, char v3,char v4, boolean dp, DC_COLOR color){
-  uint8_t img_r,img_g;
+  _print(addr,v1,v2,v3,v4,dp,color,NULL);
+}
+
+void LedControlDC::printColors(int addr, char v1, char v2, char v3,char v4, boolean dp, const DC_COLOR *colors){
+  _print(addr,v1,v2,v3,v4,dp,DC_NONE,colors);
+}
+
+void LedControlDC::_print(int addr, char v1, char v2, char v3,char v4, boolean dp, DC_COLOR color, const DC_COLOR *colors){
+  uint8_t img_r[4],img_g[4];
+  _valuesToImg(v1,v2,v3,v4,dp,color,colors,img_r,img_g);
+  for( int i=0; i<4; i++ ){
+    _setValue(addr,i,img_r[i],img_g[i]);
+  }
+// All 8 columns are in status[] now, every changed row is sent once
+  autoFlush(addr);
+}
+
+int LedControlDC::getDigitCount(){
+  return getDeviceCount()*4;
+}
+
+bool LedControlDC::_nextChar(const char *&text, char &value, bool &dp, DC_COLOR *color){
+// Color markup "#R", "#G", "#O" and "#N" changes the color of the following digits
+  while( color && text[0] == '#' && text[1] ){
+    if( text[1] == 'R' )*color = DC_RED;
+    else if( text[1] == 'G' )*color = DC_GREEN;
+    else if( text[1] == 'O' )*color = DC_ORANGE;
+    else if( text[1] == 'N' )*color = DC_NONE;
+// "##" is a '#' to be shown
+    else break;
+    text += 2;
+  }
+  if( !*text )return false;
+  value = *text++;
+  dp = false;
+// A point belongs to the character before it, a lonely point is a blank digit
+  if( value == '.' ){
+    value = ' ';
+    dp = true;
+  }
+  else if( *text == '.' ){
+    dp = true;
+    text++;
+  }
+  if( color && value == '#' && *text == '#' )text++;
+  return true;
+}
+
+int LedControlDC::_textLength(const char *text, bool markup){
+  int n = 0;
   char value1;
   bool dp1;
-  for( int i=0; i<4; i++ ){
-    switch(i){
-      case 0:  value1 = v1; dp1 = false; break;
-      case 1:  value1 = v2; dp1 = dp;    break;
-      case 2:  value1 = v3; dp1 = dp;    break;
-      default: value1 = v4; dp1 = false; break;
-    }  
-    if( color & DC_RED )img_r = _valueToImg(value1,dp1);
-    else img_r = 0; 
-    if( color & DC_GREEN )img_g = _valueToImg(value1,dp1);
-    else img_g = 0;       
-    _setValueRed(addr,i,img_r);
-    _setValueGreen(addr,i,img_g);
+  DC_COLOR color1;
+  while( _nextChar(text,value1,dp1,markup ? &color1 : NULL) )n++;
+  return n;
+}
+
+void LedControlDC::_setDigitImg(int digit, uint8_t img, DC_COLOR color){
+  _setValue(digit/4, digit%4, (color & DC_RED) ? img : 0, (color & DC_GREEN) ? img : 0);
+}
+
+void LedControlDC::print(const char *text, DC_COLOR color, DC_ALIGN align){
+  _printText(text,color,NULL,false,align);
+}
+
+void LedControlDC::printColors(const char *text, const DC_COLOR *colors, DC_ALIGN align){
+  _printText(text,DC_NONE,colors,false,align);
+}
+
+void LedControlDC::printMarkup(const char *markup, DC_ALIGN align){
+  _printText(markup,DC_ORANGE,NULL,true,align);
+}
+
+void LedControlDC::_printText(const char *text, DC_COLOR color, const DC_COLOR *colors, bool markup, DC_ALIGN align){
+  int count = getDigitCount();
+  int len   = _textLength(text,markup);
+  int index = 0;
+  int pos   = 0;
+  int skip  = 0;
+  if( align == DC_ALIGN_RIGHT ){
+// Too long text shows its end, short text is padded on the left
+    if( len > count )skip = len - count;
+    else pos = count - len;
+  }
+  for( int i=0; i<pos; i++ )_setDigitImg(i,0,DC_NONE);
+  char value1;
+  bool dp1;
+  while( pos<count && _nextChar(text,value1,dp1,markup ? &color : NULL) ){
+    DC_COLOR color1 = colors ? colors[index] : color;
+    index++;
+    if( skip > 0 ){
+      skip--;
+      continue;
+    }
+    _setDigitImg(pos++,_valueToImg(value1,dp1),color1);
+  }
+  for( ; pos<count; pos++ )_setDigitImg(pos,0,DC_NONE);
+// All devices are sent together, at most one transfer per row
+  autoCommit();
+}
+
+void LedControlDC::printNumber(long value, int decimals, DC_COLOR color, DC_ALIGN align){
+  char buf[24];
+  char *p = buf + sizeof(buf) - 1;
+  unsigned long v = value < 0 ? 0UL - (unsigned long)value : (unsigned long)value;
+  if( decimals < 0 )decimals = 0;
+  if( decimals > 9 )decimals = 9;
+  *p = '\0';
+// Digits from the right, at least one before the point
+  for( int i=0; v > 0 || i <= decimals; i++ ){
+    if( decimals > 0 && i == decimals )*--p = '.';
+    *--p = '0' + v%10;
+    v /= 10;
+  }
+  if( value < 0 )*--p = '-';
+  print(p,color,align);
+}
+
+void LedControlDC::startScroll(const char *text, DC_COLOR color, uint16_t tm, boolean repeat){
+  _scroll_text   = text;
+  _scroll_colors = NULL;
+  _scroll_color  = color;
+  _scroll_tm     = tm;
+  _scroll_repeat = repeat;
+  _scroll_len    = _textLength(text,false);
+  _scroll_active = true;
+  _scroll_wait   = false;
+  _scroll_pos    = 1 - getDigitCount();
+  _scroll_ptr    = text;
+  _scroll_index  = 0;
+}
+
+void LedControlDC::startScroll(const char *text, const DC_COLOR *colors, uint16_t tm, boolean repeat){
+  startScroll(text,DC_NONE,tm,repeat);
+  _scroll_colors = colors;
+}
+
+void LedControlDC::stopScroll(){
+  _scroll_active = false;
+}
+
+bool LedControlDC::isScrolling(){
+  return _scroll_active;
+}
+
+void LedControlDC::_updateScroll(uint32_t ms){
+  if( _scroll_wait && (uint32_t)(ms-_scroll_ms) < _scroll_tm )return;
+#ifdef LEDCONTROL_STATS
+  if( _scroll_wait )countStep(ms-_scroll_ms-_scroll_tm);
+#endif
+  _scroll_ms   = ms;
+  _scroll_wait = true;
+  int count = getDigitCount();
+  const char *p = _scroll_ptr;
+  int index = _scroll_index;
+  char value1;
+  bool dp1;
+// The text starts at the right and moves one digit to the left per step
+  for( int i=0; i<count; i++ ){
+    if( _scroll_pos + i < 0 || !_nextChar(p,value1,dp1,NULL) ){
+      _setDigitImg(i,0,DC_NONE);
+      continue;
+    }
+    DC_COLOR color = _scroll_colors ? _scroll_colors[index] : _scroll_color;
+    _setDigitImg(i,_valueToImg(value1,dp1),color);
+    index++;
+  }
+// Only the rows that changed since the last step are sent
+  autoCommit();
+  if( _scroll_pos >= 0 && _nextChar(_scroll_ptr,value1,dp1,NULL) )_scroll_index++;
+  _scroll_pos++;
+  if( _scroll_pos > _scroll_len ){
+    if( _scroll_repeat ){
+      _scroll_pos   = 1 - count;
+      _scroll_ptr   = _scroll_text;
+      _scroll_index = 0;
+    }
+    else _scroll_active = false;
   }
 }
- 
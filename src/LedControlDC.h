@@ -35,6 +35,32 @@
 #include <WProgram.h>
 #endif
 
+#include "LedTransport.h"
+#include "LedStream.h"
+
+/*
+ * Library-wide options. They change the layout of the classes, so the
+ * library and the sketch must be compiled with the same ones: uncomment
+ * them here or give them to the compiler for the whole build. A #define
+ * in the sketch is not enough. The classes live in an inline namespace
+ * named after the options, so a sketch built with other options than 
+ * the library does not link instead of corrupting memory.
+ *
+ * LEDCONTROL_STATS	bus statistics and the frame hook (see LedStats)
+ */
+//#define LEDCONTROL_STATS
+
+#ifdef LEDCONTROL_STATS
+#define LEDCONTROL_ABI_STATS _stats
+#else
+#define LEDCONTROL_ABI_STATS
+#endif
+#define LEDCONTROL_ABI_NAME(stats) LEDCONTROL_ABI_JOIN(ledcontrol,stats)
+#define LEDCONTROL_ABI_JOIN(a,b) a##b
+#define LEDCONTROL_ABI LEDCONTROL_ABI_NAME(LEDCONTROL_ABI_STATS)
+
+inline namespace LEDCONTROL_ABI {
+
 /*
  * Segments to be switched on for characters and digits on
  * 7-Segment Displays
@@ -58,23 +84,218 @@ const static byte charTable [] PROGMEM  = {
     B00000000,B00000000,B00000000,B00000000,B00000000,B00000000,B00000000,B00000000
 };
 
+/*
+ * A register write waiting in the queue of a LedControl
+ */
+struct LedQueueOp {
+    byte addr;
+    byte opcode;
+    byte data;
+};
+
+#ifdef LEDCONTROL_STATS
+/*
+ * What a LedControl did on the bus since it was created or since
+ * resetStats()
+ */
+struct LedStats {
+    /* Frames (chip select pulses) sent and bytes shifted out */
+    unsigned long frames;
+    unsigned long bytes;
+    /* Register writes not sent because the device held the value already,
+       or merged with a write waiting in the queue */
+    unsigned long elided;
+    /* Time spent sending frames, all together and the longest frame, in us */
+    unsigned long busMicros;
+    unsigned long maxMicros;
+    /* Animation and scroll steps shown later than due, and by how much at most in ms */
+    unsigned long stepsLate;
+    unsigned long maxLateMillis;
+    /* Fade steps skipped because updateFade() came too late for them */
+    unsigned long stepsDropped;
+};
+
+/*
+ * Called after each frame went out
+ * Params :
+ * data	the bytes of the frame, data[0] was shifted out first
+ * count	the number of bytes
+ * micros	the time it took in us
+ * context	what was given to setFrameHook()
+ */
+typedef void (*LedFrameHook)(const byte *data, int count, unsigned long micros, void *context);
+#endif
+
 class LedControl {
     private :
-        /* The array for shifting the data to the devices */
-        byte spidata[16];
+        /* The array for shifting the data to the devices, 2 bytes per device */
+        byte *spidata;
         /* Send out a single command to the device */
         void spiTransfer(int addr, byte opcode, byte data);
+        /* Send out the same command to all devices in a single transfer */
+        void spiBroadcast(byte opcode, byte data);
+        /* Fill spidata with no-op commands for all devices */
+        void clearFrame();
+        /* Put a command for one device into spidata */
+        void setFrame(int addr, byte opcode, byte data);
+        /* Shift spidata out to the devices and latch it, or queue it */
+        void sendFrame();
+        /* Shift a frame out through the transport and latch it */
+        void transferFrame(const byte *data);
+
+        /* The ring of register writes, NULL if every frame is sent at once */
+        volatile LedQueueOp *queue;
+        byte queueSize;
+        /* New writes go in at queueHead, service() takes them out at queueTail */
+        volatile byte queueHead;
+        volatile byte queueTail;
+        /* True while a service() takes writes out and sends them */
+        volatile bool queueBusy;
+        /* The frame built by service(), spidata belongs to the writer */
+        byte *queueData;
+        /* Put a register write into the queue, or merge it with a pending one */
+        void enqueue(byte addr, byte opcode, byte data);
 
-        /* We keep track of the led-status for all 8 devices in this array */
-        byte status[64];
-        /* Data is shifted out of this pin*/
-        int SPI_MOSI;
-        /* The clock is signaled on this pin */
-        int SPI_CLK;
-        /* This one is driven LOW for chip selectzion */
-        int SPI_CS;
+        /* The transport the frames go out through */
+        LedTransport *transport;
+        /* True if we created transport from pin numbers and have to delete it */
+        bool ownTransport;
         /* The maximum number of devices we use */
         int maxDevices;
+        /* The rows as the devices show them now (the front page), 8 for 
+           each device. status[] is the page that is drawn into. */
+        byte *front;
+        /* If true the set-functions only change status[] until commit() */
+        bool buffered;
+        /* The intensity, scan limit and decode mode last sent to each device */
+        byte *intensity;
+        byte *scanLimit;
+        byte *decodeMode;
+        /* Fade state and shutdown/display test shadow of each device 
+         * (FLAG_ bits) */
+        byte *flags;
+        /* True if any fade runs */
+        bool fading;
+        /* Start and target intensity, start time and duration of each fade in ms */
+        byte *fadeFrom;
+        byte *fadeTarget;
+        uint32_t *fadeStart;
+        uint32_t *fadeTime;
+
+        /* The next frame of a running resync, RESYNC_IDLE if none runs */
+        byte resyncStep;
+        /* Time between two automatic resyncs in ms (0 for none), and when the last one started */
+        uint32_t resyncInterval;
+        uint32_t resyncStart;
+
+        /* The frame stream being played (NULL if none), the next record,
+           and the wait of the last LED_STREAM_WAIT from streamStart on */
+        const byte *stream;
+        const byte *streamPos;
+        bool streamProgmem;
+        bool streamWaiting;
+        uint16_t streamWait;
+        uint32_t streamStart;
+        /* Read the next byte of the stream */
+        byte streamByte();
+
+#ifdef LEDCONTROL_STATS
+        LedStats stats;
+        LedFrameHook frameHook;
+        void *frameHookContext;
+#endif
+
+        /* The RAM block all the per-device state is carved from */
+        byte *memory;
+        /* True if we allocated memory and have to free it */
+        bool ownMemory;
+
+        /* Set up the memory, the transport and all devices */
+        void init(int numDevices, byte *memory, int extraSize);
+        /* Write a row into status[] and send it unless we are buffered */
+        void updateRow(int addr, int row, byte value);
+        /* The part of a register value the device uses, what the shadows hold */
+        static byte shadowValue(byte opcode, byte data);
+        /* Remember a value written to a register of a device */
+        void setShadow(int addr, byte opcode, byte data);
+        /* True if the register of the device holds the value already */
+        bool isShadowed(int addr, byte opcode, byte data);
+        /* Send a register value to a device unless it holds it already */
+        void writeRegister(int addr, byte opcode, byte data);
+        /* Same for all devices in one transfer, no-ops for those holding it */
+        void writeRegisterAll(byte opcode, byte data);
+        /* Send a register value to all devices whatever they hold */
+        void forceBroadcast(byte opcode, byte data);
+
+    protected:
+        /* We keep track of the led-status for all devices in this array, 8 rows each */
+        byte *status;
+        /* Rows changed in status[] but not sent yet, one bit per row and device */
+        byte *dirty;
+
+        /*
+         * Create a controler whose per-device state lives in memory. If 
+         * memory is NULL it is allocated for at most 8 devices, with 
+         * extraSize bytes per device behind it for the derived class.
+         * With pin numbers the LedBitBangTransport is created with new, 
+         * a controler on a transport of its own has none.
+         * Params :
+         * memory	memorySize(numDevices) bytes (4 byte aligned) plus extraSize 
+         *		per device, or NULL
+         * extraSize	the bytes per device for the derived class
+         */
+        LedControl(int dataPin, int clkPin, int csPin, int numDevices, byte *memory, int extraSize);
+        LedControl(LedTransport &transport, int numDevices, byte *memory, int extraSize);
+
+        /*
+         * The memory behind our own per-device state, extraSize bytes 
+         * per device.
+         */
+        byte *extraMemory();
+
+#ifdef LEDCONTROL_STATS
+        /*
+         * Count a step of an animation that was due late ms ago.
+         */
+        void countStep(uint32_t late);
+#endif
+
+        /*
+         * Set all 8 Led's of one or more columns in status[] only. Rows 
+         * which really change are marked dirty and sent by the next flush().
+         * Params:
+         * addr	address of the display
+         * mask	the columns which are to be set, B10000000 is column 0
+         * value	each bit set to 1 will light up the
+         *		corresponding Led in every column of the mask.
+         */
+        void writeColumns(int addr, byte mask, byte value);
+
+        /*
+         * Send the dirty rows of a device, but only if we are not buffered.
+         * Params:
+         * addr	address of the display
+         */
+        void autoFlush(int addr);
+
+        /*
+         * Send the dirty rows of all devices together, but only if we 
+         * are not buffered.
+         */
+        void autoCommit();
+
+        /*
+         * Mark a device for commitMarked().
+         */
+        void markDevice(int addr);
+
+        /*
+         * Send the dirty rows of the marked devices together and clear 
+         * the marks. The rows of other devices are not sent. In buffered
+         * mode nothing is sent, the rows wait for commit() like all 
+         * others.
+         */
+        void commitMarked();
 
     public:
         /* 
@@ -83,10 +304,48 @@ class LedControl {
          * dataPin		pin on the Arduino where data gets shifted out
          * clockPin		pin for the clock
          * csPin		pin for selecting the device 
-         * numDevices	maximum number of devices that can be controled
+         * numDevices	maximum number of devices that can be controled (1..8)
          */
         LedControl(int dataPin, int clkPin, int csPin, int numDevices=1);
 
+        /* 
+         * Create a new controler that sends its data through a transport, 
+         * e.g. a LedSPITransport for the hardware SPI of the board.
+         * The transport must live as long as the controler.
+         * Params :
+         * transport	the transport connected to the devices
+         * numDevices	maximum number of devices that can be controled (1..8)
+         */
+        LedControl(LedTransport &transport, int numDevices=1);
+
+        ~LedControl();
+
+        /* 
+         * A controler owns its RAM and its transport, it can not be 
+         * copied. It can be moved, as in LedControl lc=LedControl(12,11,10,1);
+         * The new controler takes over the RAM, the transport and the state
+         * of the devices, the old one is left without devices. 
+         * LedControlT keeps its RAM inside the object and can not be moved.
+         * Params :
+         * other	the controler to take over
+         */
+        LedControl(LedControl &&other);
+        LedControl(const LedControl &)=delete;
+        LedControl &operator=(const LedControl &)=delete;
+
+        /*
+         * Gets the RAM needed for the per-device state of a chain.
+         * Params :
+         * numDevices	the number of devices on the chain
+         * Returns :
+         * int	the number of bytes
+         */
+        static constexpr int memorySize(int numDevices) {
+            //fadeStart and fadeTime, status, front, dirty, spidata, queueData,
+            //intensity, scanLimit, decodeMode, fadeFrom, fadeTarget and flags
+            return numDevices*(4+4+8+8+1+2+2+1+1+1+1+1+1);
+        }
+
         /*
          * Gets the number of devices attached to this LedControl.
          * Returns :
@@ -103,6 +362,99 @@ class LedControl {
          */
         void shutdown(int addr, bool status);
 
+        /*
+         * Set the shutdown (power saving) mode for all devices
+         * with a single transfer.
+         * Params :
+         * status	If true the devices go into power-down mode. Set to false
+         *		for normal operation.
+         */
+        void shutdownAll(bool status);
+
+        /*
+         * Tells if a device is in shutdown mode. Like all the getters below
+         * it answers from what was sent to the device. The set-functions
+         * send nothing if a register holds the new value already.
+         * Params :
+         * addr	The address of the display
+         * Returns :
+         * bool	true if the device is in power-down mode
+         */
+        bool isShutdown(int addr);
+
+        /*
+         * Switch the display test mode (all Leds on) of a device.
+         * Params :
+         * addr	The address of the display to control
+         * on	true for the test mode, false for normal operation
+         */
+        void setDisplayTest(int addr, bool on);
+
+        /*
+         * Tells if a device is in display test mode.
+         * Params :
+         * addr	The address of the display
+         * Returns :
+         * bool	true if all Leds are on for the test
+         */
+        bool isDisplayTest(int addr);
+
+        /*
+         * Gets the decode mode of a device. LedControl decodes the digits
+         * itself, so this is 0 unless spiTransferAll() changed it.
+         * Params :
+         * addr	The address of the display
+         * Returns :
+         * int	the decode mode register, -1 for a wrong address
+         */
+        int getDecodeMode(int addr);
+
+        /*
+         * Switch the frame-buffer mode on or off. In buffered mode
+         * setLed(), setRow(), setColumn(), setDigit(), setChar() and 
+         * clearDisplay() only change the led-status in memory, nothing
+         * is sent until commit(), swap() or flush() is called. Switching 
+         * the mode off commits all pending rows.
+         * Params :
+         * enable	true for buffered mode, false for immediate updates
+         */
+        void setBuffered(bool enable);
+
+        /*
+         * Tells if the frame-buffer mode is switched on.
+         * Returns :
+         * bool	true if the set-functions are buffered
+         */
+        bool isBuffered();
+
+        /*
+         * Send every row that differs from what the devices show on all 
+         * devices. Devices are updated together, so this costs at most one
+         * transfer per row for the whole chain. A row that was changed 
+         * and changed back, or a frame that did not change, costs no 
+         * transfer at all.
+         */
+        void commit();
+
+        /*
+         * Page flipping: switch to buffered mode if needed and show the 
+         * page drawn since the last swap() on all devices at once, with
+         * commit(). Draw the next page with the set-functions, then call 
+         * swap() again. Keeps values spanning several devices from being
+         * seen half old and half new. Nothing else shows the page being 
+         * drawn: animation steps, blinking and blending of LedControlDC 
+         * go into it as well and appear with the next swap().
+         */
+        void swap();
+
+        /*
+         * Send every row of a single device that differs from what the 
+         * device shows, one transfer per row.
+         * Params :
+         * addr	address of the display
+         */
+        void flush(int addr);
+
         /* 
          * Set the number of digits (or rows) to be displayed.
          * See datasheet for sideeffects of the scanlimit on the brightness
@@ -113,6 +465,15 @@ class LedControl {
          */
         void setScanLimit(int addr, int limit);
 
+        /*
+         * Gets the scan limit of a device.
+         * Params :
+         * addr	address of the display
+         * Returns :
+         * int	the scan limit register (0..7), -1 for a wrong address
+         */
+        int getScanLimit(int addr);
+
         /* 
          * Set the brightness of the display.
          * Params:
@@ -121,6 +482,155 @@ class LedControl {
          */
         void setIntensity(int addr, int intensity);
 
+        /*
+         * Gets the brightness of a device, while fading the step that 
+         * was sent last.
+         * Params:
+         * addr		the address of the display
+         * Returns :
+         * int	the intensity (0..15), -1 if it was not set since the start
+         */
+        int getIntensity(int addr);
+
+        /*
+         * Set the brightness of all devices with a single transfer.
+         * Params:
+         * intensity	the brightness of the displays. (0..15)
+         */
+        void setIntensityAll(int intensity);
+
+        /*
+         * Fade the brightness of a display to a new intensity without blocking.
+         * The fade follows a gamma curve, so it looks even to the eye, and runs
+         * while updateFade() is called. Fades of all devices run together, 
+         * each step is a single transfer for the whole chain.
+         * setIntensity() stops the fade of the device.
+         * Params:
+         * addr		the address of the display to control
+         * intensity	the brightness at the end of the fade. (0..15)
+         * duration	time of the fade in ms
+         */
+        void fadeTo(int addr, int intensity, uint32_t duration);
+
+        /*
+         * Fade the brightness of all devices to the same intensity.
+         * Params:
+         * intensity	the brightness at the end of the fade. (0..15)
+         * duration	time of the fade in ms
+         */
+        void fadeAllTo(int intensity, uint32_t duration);
+
+        /*
+         * Advance the running fades, call it often from loop().
+         * LedControlDC::update() does this already.
+         * Params:
+         * ms		the current time, usually millis()
+         * Returns :
+         * bool	true if no fade is running anymore
+         */
+        bool updateFade(uint32_t ms);
+
+        /*
+         * Tells if a fade is running on any device.
+         * Returns :
+         * bool	true while a fade is running
+         */
+        bool isFading();
+
+        /*
+         * Send the whole state we keep for the devices again: display test,
+         * scan limit, decode mode, intensity, the rows and the shutdown mode.
+         * This repairs devices that got garbage from noise on the lines. 
+         * It is sent one frame for the whole chain per updateResync(), 
+         * 13 frames in all. The rows are sent as the devices should show 
+         * them now, rows not committed yet in buffered mode are left to 
+         * commit().
+         */
+        void resync();
+
+        /*
+         * Start a resync() every interval ms from updateResync().
+         * Params:
+         * interval	time between two resyncs in ms, 0 switches it off
+         */
+        void setAutoResync(uint32_t interval);
+
+        /*
+         * Send the next frame of a running resync, start one if it is time
+         * for the automatic resync. LedControlDC::update() does this already.
+         * Params:
+         * ms		the current time, usually millis()
+         * Returns :
+         * bool	true if no resync is running
+         */
+        bool updateResync(uint32_t ms);
+
+        /*
+         * Start playing a frame stream (see LedStream.h) from 
+         * updateStream(). The first records are sent with the next call.
+         * The stream writes the registers directly, the state we keep
+         * for the devices follows it.
+         * Params :
+         * stream	the stream, it must stay valid while it is played
+         * progmem	true if the stream is in PROGMEM, false for RAM
+         */
+        void play(const byte *stream, bool progmem=true);
+
+        /*
+         * Stop the stream, the devices keep what they show.
+         */
+        void stopStream();
+
+        /*
+         * Tells if a stream is playing.
+         * Returns :
+         * bool	true until the end of the stream or stopStream()
+         */
+        bool isPlaying();
+
+        /*
+         * Send the records of the stream that are due. update() does
+         * this already.
+         * Params:
+         * ms		the current time, usually millis()
+         * Returns :
+         * bool	true if no stream is playing
+         */
+        bool updateStream(uint32_t ms);
+
+        /*
+         * Run the fades, the stream and the resync, call it often from 
+         * loop().
+         * Params:
+         * ms		the current time, usually millis()
+         * Returns :
+         * bool	true if no fade or stream is running, a resync does not count
+         */
+        bool update(uint32_t ms);
+
+#ifdef LEDCONTROL_STATS
+        /*
+         * Gets the bus statistics.
+         * Returns :
+         * LedStats	the counters since the start or the last resetStats()
+         */
+        const LedStats &getStats();
+
+        /*
+         * Set all statistics back to 0.
+         */
+        void resetStats();
+
+        /*
+         * Set a function that is called after every frame, e.g. to trace 
+         * the bus on the serial port. NULL removes it.
+         * Params :
+         * hook	the function
+         * context	passed on to the function
+         */
+        void setFrameHook(LedFrameHook hook, void *context=NULL);
+#endif
+
         /* 
          * Switch all Leds on the display off. 
          * Params:
@@ -128,6 +638,58 @@ class LedControl {
          */
         void clearDisplay(int addr);
 
+        /*
+         * Switch all Leds on all devices off, one transfer per row 
+         * for the whole chain.
+         */
+        void clearAll();
+
+        /*
+         * Send one command to every device on the chain in a single 
+         * transfer, each device getting its own data byte.
+         * Params:
+         * opcode	the register of the MAX7219 to be written (see datasheet)
+         * data	the values for the devices, one byte for each device
+         *		starting with address 0
+         */
+        void spiTransferAll(byte opcode, const byte *data);
+
+        /*
+         * Switch the background queue on or off. With a queue every
+         * register write is stored in the buffer and returns at once,
+         * service() sends them later, e.g. from a timer interrupt. A write
+         * to a register that is still waiting in the queue only changes the
+         * waiting value. If the queue is full the write waits while it sends
+         * one frame itself. Interrupts are only off while the indices of
+         * the queue change, never while a frame goes out.
+         * Switching the queue off sends everything still waiting.
+         * Params:
+         * buffer	the memory for the queue, must live as long as it is used. 
+         *		NULL switches the queue off.
+         * size	number of writes in buffer (2..255), one of them stays free
+         */
+        void setQueue(LedQueueOp *buffer, int size);
+
+        /*
+         * Send waiting writes from the queue. Writes to different devices
+         * go out together, so a frame carries up to one write per device.
+         * Call it from loop() or a timer interrupt. A call that comes 
+         * while another one sends (an interrupt during the one in loop())
+         * returns false at once.
+         * Params:
+         * maxFrames	the number of frames to send at most
+         * Returns :
+         * bool	true if the queue is empty now
+         */
+        bool service(int maxFrames=1);
+
+        /*
+         * Gets the number of writes waiting in the queue.
+         * Returns :
+         * int	the writes not sent yet, 0 without a queue
+         */
+        int getQueueCount();
+
         /* 
          * Set the status of a single Led.
          * Params :
@@ -149,6 +711,17 @@ class LedControl {
          */
         void setRow(int addr, int row, byte value);
 
+        /*
+         * Gets the state of the 8 Led's in a row, in buffered mode it
+         * may not have been sent yet.
+         * Params:
+         * addr	address of the display
+         * row	the row (0..7)
+         * Returns :
+         * byte	the Leds of the row, bit 7 is column 0
+         */
+        byte getRow(int addr, int row);
+
         /* 
          * Set all 8 Led's in a column to a new state
          * Params:
@@ -184,6 +757,34 @@ class LedControl {
         void setChar(int addr, int digit, char value, boolean dp);
 };
 
+/*
+ * RAM for the per-device state of a chain. It is a base class of the 
+ * templates, so it is there before LedControl is constructed.
+ */
+template<int SIZE> struct LedMemory {
+    uint32_t ledMemory[(SIZE+3)/4];
+};
+
+/*
+ * A LedControl for a chain of exactly N devices, with RAM for N devices
+ * and no more. N is not limited to 8. With pin numbers it still creates
+ * its LedBitBangTransport with new, LedControlFast (LedControlFast.h)
+ * does without.
+ */
+template<int N> class LedControlT: private LedMemory<LedControl::memorySize(N)>, public LedControl {
+    static_assert(N>=1 && N<=255,"a chain has 1..255 devices");
+    public:
+        LedControlT(int dataPin, int clkPin, int csPin):
+        LedControl(dataPin,clkPin,csPin,N,(byte *)this->ledMemory,0) {}
+
+        LedControlT(LedTransport &transport):
+        LedControl(transport,N,(byte *)this->ledMemory,0) {}
+
+        /* The RAM is part of the object, it can not be copied or moved */
+        LedControlT(const LedControlT &)=delete;
+        LedControlT(LedControlT &&)=delete;
+};
+
 // Знакогенератор
 const uint8_t characterArrayDC[] PROGMEM = {
 //  ABCDEFG  Segments    
@@ -224,7 +825,7 @@ const uint8_t characterArrayDC[] PROGMEM = {
   0b01000100, // 34 '"'
   0b00000000, // 35 '#'  NO DISPLAY
   0b00000000, // 36 '$'  NO DISPLAY
-  0b00100100, // 37 '%'  Р—Р°РЅС‡РµРє РїСЂРѕС†РµРЅС‚Р°
+  0b00100100, // 37 '%'  Значок процента
   0b00000000, // 38 '&'  NO DISPLAY
   0b01000000, // 39 '''
   0b10011100, // 40 '('
@@ -317,6 +918,21 @@ const uint8_t characterArrayDC[] PROGMEM = {
   0b00000000, // 127 'DEL'  NO DISPLAY
 }; 
 
+// A font maps character codes to segment images. The codes first .. first+count-1
+// are in glyphs (PROGMEM, one image per code), all other codes are looked up in
+// the next font. If no font has the code, fallback of the first font is used.
+// Fonts with a few codes spread over the table are built from small chained ones.
+struct DCFont {
+   const uint8_t *glyphs;
+   uint8_t        first;
+   uint16_t       count;
+   uint8_t        fallback;
+   const DCFont  *next;
+};
+
+// The built-in font, codes 0..127, blank for all other codes
+constexpr DCFont DC_FONT_DEFAULT = { characterArrayDC, 0, 128, 0b00000000, NULL };
+
 typedef enum {
    DC_NONE   = 0,
    DC_RED    = 1,
@@ -324,21 +940,307 @@ typedef enum {
    DC_ORANGE = 3,
 }DC_COLOR;
 
+// Wiring of a dual color module: the column mask (B10000000 is column 0)
+// of the red and the green leds of each digit. It is given at run time.
+// There is no glyph table per layout, writeColumns() spreads the glyph
+// over the 8 rows with a test and a shift per row
+struct DCLayout {
+   uint8_t red[4];
+   uint8_t green[4];
+};
+
+constexpr uint8_t dcColumn(int col){ return 0b10000000 >> col; }
+
+// The wiring of the samopal.pro module, red on columns 1-4, green on 5,6,7,0
+constexpr DCLayout DC_LAYOUT_DEFAULT = {
+   { dcColumn(1), dcColumn(2), dcColumn(3), dcColumn(4) },
+   { dcColumn(5), dcColumn(6), dcColumn(7), dcColumn(0) }
+};
+
+// Alignment of text on the whole chain
+typedef enum {
+   DC_ALIGN_LEFT  = 0,
+   DC_ALIGN_RIGHT = 1,
+}DC_ALIGN;
+
+// What a transition step shows on its digits
+typedef enum {
+   DC_STEP_MASK        = 0, // old and new image of the same digit
+   DC_STEP_SLIDE_LEFT  = 1, // old digits moved arg digits to the left, new following
+   DC_STEP_SLIDE_RIGHT = 2, // old digits moved arg digits to the right, new in front
+}DC_STEP_OP;
+
+// One step of a transition from the old to the new image of the 4 digits of
+// a device. Every digit in the digits mask (bit 0 is digit 0) shows
+// red (old & rOld) | (new & rNew) and green (old & gOld) | (new & gNew),
+// the other digits are left as they are. The step stays ticks*tm ms on the
+// display, a step with 0 ticks is shown together with the next one.
+struct DCStep {
+   uint8_t op;
+   uint8_t digits;
+   uint8_t arg;
+   uint8_t ticks;
+   uint8_t rOld, rNew;
+   uint8_t gOld, gNew;
+};
+
+// A table of steps in PROGMEM, played by the non-blocking engine of LedControlDC.
+// The next transition (if any) is played after the last step.
+struct DCTransition {
+   const DCStep       *steps;
+   uint8_t             count;
+   const DCTransition *next;
+};
+
+#define DC_STEP(digits,rOld,rNew,gOld,gNew) { DC_STEP_MASK, digits, 0, 1, rOld, rNew, gOld, gNew }
+#define DC_STEP_OLD(digits,mask) DC_STEP(digits,mask,0,mask,0)
+#define DC_STEP_NEW(digits,mask) DC_STEP(digits,0,mask,0,mask)
+#define DC_STEP_WIPE(mask)       DC_STEP(0b1111,(uint8_t)~(mask),mask,(uint8_t)~(mask),mask)
+#define DC_STEP_SLIDE(op,arg)    { op, 0b1111, arg, 1, 0xFF, 0xFF, 0xFF, 0xFF }
+#define DC_TRANSITION(steps,next) { steps, sizeof(steps)/sizeof(DCStep), next }
+
+// clearAnimation(): digit by digit to the middle segment, the point of digit 2 first
+const static DCStep dcStepsClear[] PROGMEM = {
+  DC_STEP_OLD(0b0001,0b11110011), DC_STEP_OLD(0b0001,0b01100001), DC_STEP_OLD(0b0001,0b00000000),
+  DC_STEP_OLD(0b0010,0b11110011), DC_STEP_OLD(0b0010,0b01100001), DC_STEP_OLD(0b0010,0b00000000),
+  DC_STEP_OLD(0b0100,0b11110010), DC_STEP_OLD(0b0100,0b01100000), DC_STEP_OLD(0b0100,0b00000000),
+  DC_STEP_OLD(0b1000,0b11110011), DC_STEP_OLD(0b1000,0b01100001), DC_STEP_OLD(0b1000,0b00000000),
+};
+
+// printAnimation(): digit by digit from the middle segment
+const static DCStep dcStepsPrint[] PROGMEM = {
+  DC_STEP_NEW(0b0001,0b00001100), DC_STEP_NEW(0b0001,0b10011111), DC_STEP_NEW(0b0001,0b11111111),
+  DC_STEP_NEW(0b0010,0b00001100), DC_STEP_NEW(0b0010,0b10011111), DC_STEP_NEW(0b0010,0b11111111),
+  DC_STEP_NEW(0b0100,0b00001100), DC_STEP_NEW(0b0100,0b10011111), DC_STEP_NEW(0b0100,0b11111111),
+  DC_STEP_NEW(0b1000,0b00001100), DC_STEP_NEW(0b1000,0b10011111), DC_STEP_NEW(0b1000,0b11111111),
+};
+
+// New image from the top (segment A) down to D and the point, all digits together
+const static DCStep dcStepsWipeDown[] PROGMEM = {
+  DC_STEP_WIPE(0b10000000), DC_STEP_WIPE(0b11000100), DC_STEP_WIPE(0b11000110),
+  DC_STEP_WIPE(0b11101110), DC_STEP_WIPE(0b11111111),
+};
+
+// New image from the bottom up
+const static DCStep dcStepsWipeUp[] PROGMEM = {
+  DC_STEP_WIPE(0b00010001), DC_STEP_WIPE(0b00111001), DC_STEP_WIPE(0b00111011),
+  DC_STEP_WIPE(0b01111111), DC_STEP_WIPE(0b11111111),
+};
+
+// Blank, then the new image drawn segment by segment A..G and the point
+const static DCStep dcStepsDraw[] PROGMEM = {
+  DC_STEP_NEW(0b1111,0b10000000), DC_STEP_NEW(0b1111,0b11000000), DC_STEP_NEW(0b1111,0b11100000),
+  DC_STEP_NEW(0b1111,0b11110000), DC_STEP_NEW(0b1111,0b11111000), DC_STEP_NEW(0b1111,0b11111100),
+  DC_STEP_NEW(0b1111,0b11111110), DC_STEP_NEW(0b1111,0b11111111),
+};
+
+const static DCStep dcStepsSlideLeft[] PROGMEM = {
+  DC_STEP_SLIDE(DC_STEP_SLIDE_LEFT,1), DC_STEP_SLIDE(DC_STEP_SLIDE_LEFT,2),
+  DC_STEP_SLIDE(DC_STEP_SLIDE_LEFT,3), DC_STEP_SLIDE(DC_STEP_SLIDE_LEFT,4),
+};
+
+const static DCStep dcStepsSlideRight[] PROGMEM = {
+  DC_STEP_SLIDE(DC_STEP_SLIDE_RIGHT,1), DC_STEP_SLIDE(DC_STEP_SLIDE_RIGHT,2),
+  DC_STEP_SLIDE(DC_STEP_SLIDE_RIGHT,3), DC_STEP_SLIDE(DC_STEP_SLIDE_RIGHT,4),
+};
+
+// Old and new image on top of each other for 2 ticks, then the new one.
+// A color change of the same text goes over orange.
+const static DCStep dcStepsCrossFade[] PROGMEM = {
+  { DC_STEP_MASK, 0b1111, 0, 2, 0xFF, 0xFF, 0xFF, 0xFF },
+  DC_STEP_NEW(0b1111,0b11111111),
+};
+
+// New image digit by digit from the left, each digit wiped down
+const static DCStep dcStepsStagger[] PROGMEM = {
+  DC_STEP(0b0001,0b01111111,0b10000000,0b01111111,0b10000000),
+  DC_STEP(0b0001,0b00111001,0b11000110,0b00111001,0b11000110),
+  { DC_STEP_MASK, 0b0001, 0, 0, 0, 0xFF, 0, 0xFF }, DC_STEP(0b0010,0b01111111,0b10000000,0b01111111,0b10000000),
+  DC_STEP(0b0010,0b00111001,0b11000110,0b00111001,0b11000110),
+  { DC_STEP_MASK, 0b0010, 0, 0, 0, 0xFF, 0, 0xFF }, DC_STEP(0b0100,0b01111111,0b10000000,0b01111111,0b10000000),
+  DC_STEP(0b0100,0b00111001,0b11000110,0b00111001,0b11000110),
+  { DC_STEP_MASK, 0b0100, 0, 0, 0, 0xFF, 0, 0xFF }, DC_STEP(0b1000,0b01111111,0b10000000,0b01111111,0b10000000),
+  DC_STEP(0b1000,0b00111001,0b11000110,0b00111001,0b11000110),
+  DC_STEP_NEW(0b1000,0b11111111),
+};
+
+constexpr DCTransition DC_TRANSITION_CLEAR       = DC_TRANSITION(dcStepsClear,NULL);
+constexpr DCTransition DC_TRANSITION_PRINT       = DC_TRANSITION(dcStepsPrint,NULL);
+constexpr DCTransition DC_TRANSITION_CLEAR_PRINT = DC_TRANSITION(dcStepsClear,&DC_TRANSITION_PRINT);
+constexpr DCTransition DC_TRANSITION_WIPE_DOWN   = DC_TRANSITION(dcStepsWipeDown,NULL);
+constexpr DCTransition DC_TRANSITION_WIPE_UP     = DC_TRANSITION(dcStepsWipeUp,NULL);
+constexpr DCTransition DC_TRANSITION_DRAW        = DC_TRANSITION(dcStepsDraw,NULL);
+constexpr DCTransition DC_TRANSITION_SLIDE_LEFT  = DC_TRANSITION(dcStepsSlideLeft,NULL);
+constexpr DCTransition DC_TRANSITION_SLIDE_RIGHT = DC_TRANSITION(dcStepsSlideRight,NULL);
+constexpr DCTransition DC_TRANSITION_CROSSFADE   = DC_TRANSITION(dcStepsCrossFade,NULL);
+constexpr DCTransition DC_TRANSITION_STAGGER     = DC_TRANSITION(dcStepsStagger,NULL);
+
+// A transition running on addr, step is the next step of trans and ticks the time
+// of the last one in tm ms. rOld/gOld and rNew/gNew are the old and new image of
+// the 4 digits
+struct DCAnimation {
+   const DCTransition *trans;
+   int      addr;
+   uint8_t  step;
+   uint8_t  ticks;
+   uint16_t tm;
+   uint32_t ms;
+   bool     active;
+   bool     wait;
+   uint8_t  rOld[4];
+   uint8_t  gOld[4];
+   uint8_t  rNew[4];
+   uint8_t  gNew[4];
+};
+
 class LedControlDC: public LedControl {
   private: 
-     char _buffer_r[4];
-     char _buffer_g[4];
-     void _setValueRed(int addr, int value, uint8_t img);
-     void _setValueGreen(int addr, int value, uint8_t img);
+// Red and green image of the 4 digits of every device, digit of addr at addr*4
+     uint8_t *_buffer_r;
+     uint8_t *_buffer_g;
+     const DCLayout *_layout;
+     const DCFont   *_font;
+     void _setValue(int addr, int digit, uint8_t img_r, uint8_t img_g);
+     void _showValue(int addr, int digit);
+// Red share of orange digits in 1/16 for every device (0 no blending),
+// error accumulator and the color shown in this tick (1 = red)
+     uint8_t *_blend;
+     uint8_t *_blend_acc;
+     uint8_t *_blend_red;
+// Digits of every device that blink, shown dark while _blink_off.
+// One rate (_blink_tm ms, 0 no blinking) for the whole chain
+     uint8_t *_blink;
+     bool     _blink_off;
+     bool     _blink_wait;
+     uint16_t _blink_tm;
+     uint32_t _blink_ms;
+     void _updateBlink(uint32_t ms);
+     void _showDevice(int addr);
+     void _bulk(int addr, uint8_t op, DC_COLOR color);
+     void _init(const DCLayout &layout);
      uint8_t _valueToImg( char value, bool dp );
+     void _valuesToImg(char v1, char v2, char v3,char v4, boolean dp, DC_COLOR color, const DC_COLOR *colors, uint8_t *img_r, uint8_t *img_g);
+     void _print(int addr, char v1, char v2, char v3,char v4, boolean dp, DC_COLOR color, const DC_COLOR *colors);
+     void _printText(const char *text, DC_COLOR color, const DC_COLOR *colors, bool markup, DC_ALIGN align);
+// clearAnimation() and printAnimation() run a transition of their own with delay()
+     void _startAnimation(DCAnimation &anim, int addr, const DCTransition &transition, uint16_t tm);
+     bool _animationDone(DCAnimation &anim);
+     void _animationStep(DCAnimation &anim);
+     void _runAnimation(DCAnimation &anim);
+// The transition run by update()
+     DCAnimation _anim;
+     bool _updateAnimation(uint32_t ms);
+// State of the scrolling text, _scroll_pos is the character on the left digit
+     bool     _scroll_active;
+     bool     _scroll_wait;
+     bool     _scroll_repeat;
+     const char *_scroll_text;
+     const DC_COLOR *_scroll_colors;
+     DC_COLOR _scroll_color;
+     int      _scroll_len;
+     int      _scroll_pos;
+     const char *_scroll_ptr;
+     int      _scroll_index;
+     uint16_t _scroll_tm;
+     uint32_t _scroll_ms;
+     void _updateScroll(uint32_t ms);
+     bool _nextChar(const char *&text, char &value, bool &dp, DC_COLOR *color);
+     int  _textLength(const char *text, bool markup);
+     void _setDigitImg(int digit, uint8_t img, DC_COLOR color);
+  protected:
+// State of the devices in memory (see LedControl), NULL to allocate it for up to 8 devices
+     LedControlDC(int dataPin, int clkPin, int csPin, int numDevices, const DCLayout &layout, byte *memory);
+     LedControlDC(LedTransport &transport, int numDevices, const DCLayout &layout, byte *memory);
   public:
-     LedControlDC(int dataPin, int clkPin, int csPin, int numDevices=1);
+     LedControlDC(int dataPin, int clkPin, int csPin, int numDevices=1, const DCLayout &layout=DC_LAYOUT_DEFAULT);
+     LedControlDC(LedTransport &transport, int numDevices=1, const DCLayout &layout=DC_LAYOUT_DEFAULT);
+// Takes over the RAM, the transport and the digits of other, like LedControl
+     LedControlDC(LedControlDC &&other)=default;
+// RAM for the state of numDevices devices, LedControl and the digit buffers
+     static constexpr int memorySize(int numDevices){ return LedControl::memorySize(numDevices) + numDevices*DEVICE_SIZE; }
+     static constexpr int DEVICE_SIZE = 4+4+1+1+1+1;
      void setChar(int addr, int digit, char value, boolean dp, DC_COLOR color);
      void setCharDC(int addr, int digit, char value_r, boolean dp_r,char value_g, boolean dp_g );
      void clearAnimation(int addr, uint16_t tm);
      void printAnimation(int addr, char v1, char v2, char v3,char v4, boolean dp, DC_COLOR color,uint16_t tm);
      void print(int addr, char v1, char v2, char v3,char v4, boolean dp, DC_COLOR color);
+// Same with a color for each of the 4 digits
+     void printColors(int addr, char v1, char v2, char v3,char v4, boolean dp, const DC_COLOR *colors);
+// Font used for all characters, the font must stay valid while it is used
+     void setFont(const DCFont &font);
+     const DCFont &getFont();
+     uint8_t getGlyph(char value);
+// Runs what is started with the calls below, the blinking and the fades, streams
+// and resync of LedControl. Call update(millis()) from loop()
+     bool update(uint32_t ms);
+// Non-blocking animations: start one, then call update(millis()) from loop().
+// In buffered mode each step is shown by the next commit() or swap()
+     void startClearAnimation(int addr, uint16_t tm);
+     void startPrintAnimation(int addr, char v1, char v2, char v3,char v4, boolean dp, DC_COLOR color,uint16_t tm, boolean clear=false);
+     bool isAnimating();
+// Any transition (DC_TRANSITION_WIPE_DOWN, DC_TRANSITION_SLIDE_LEFT, ... or a table
+// of your own) from the digits shown now to the new ones, one tick every tm ms
+     void startTransition(int addr, const DCTransition &transition, char v1, char v2, char v3,char v4, boolean dp, DC_COLOR color, uint16_t tm);
+// The whole chain as one display of 4*numDevices digits, device 0 on the left.
+// A '.' in the text lights the point of the digit before it.
+     int  getDigitCount();
+     void print(const char *text, DC_COLOR color, DC_ALIGN align=DC_ALIGN_LEFT);
+// Text with a color for each digit of the text
+     void printColors(const char *text, const DC_COLOR *colors, DC_ALIGN align=DC_ALIGN_LEFT);
+// Text with color markup: "#R", "#G", "#O" or "#N" set the color of the following
+// digits (orange at the start), "##" is a '#'. E.g. "#R-23#G~"
+     void printMarkup(const char *markup, DC_ALIGN align=DC_ALIGN_LEFT);
+     void printNumber(long value, int decimals, DC_COLOR color, DC_ALIGN align=DC_ALIGN_RIGHT);
+// Text scrolling from right to left over the whole chain, one digit every tm ms,
+// driven by update(). The text (and colors, one per digit) must stay valid.
+     void startScroll(const char *text, DC_COLOR color, uint16_t tm, boolean repeat=true);
+     void startScroll(const char *text, const DC_COLOR *colors, uint16_t tm, boolean repeat=true);
+     void stopScroll();
+     bool isScrolling();
+// Color blending: orange digits of addr show red for red/16 of the ticks and green
+// for the rest, red 1..15 gives the hues from green-yellow to amber, 0 is plain
+// orange again. Call tick() at a steady rate from loop(), not from an interrupt:
+// it draws and sends like the other calls. Each switch of the color costs up to
+// 8 frames of the whole chain, so the rate has to suit the length of the chain
+// and the transport; 16 ticks are one period of the blend.
+     void setBlend(int addr, uint8_t red);
+     uint8_t getBlend(int addr);
+     void tick();
+// Whole-display operations on the red and green images of addr, or of all devices
+// without addr. They change the rows in status[] and send only the changed rows,
+// the devices of the chain together. clear() also darkens LEDs outside the layout.
+     void clear(int addr);
+     void clear();
+     void fill(int addr, DC_COLOR color);
+     void fill(DC_COLOR color);
+     void invert(int addr);
+     void invert();
+     void swapColors(int addr);
+     void swapColors();
+// Same as clear(), the images are cleared too
+     void clearDisplay(int addr);
+     void clearAll();
+// The digits in the mask (bit 0 the left digit) of addr blink, tm ms on and tm ms off,
+// driven by update(). A mask of 0 stops blinking, tm is shared by all devices.
+// In buffered mode the switches wait for commit() or swap()
+     void blink(int addr, uint8_t digits, uint16_t tm);
+     uint8_t getBlink(int addr);
   
 };
 
+// A LedControlDC for a chain of exactly N devices (4*N digits), not limited to 8
+template<int N> class LedControlDCT: private LedMemory<LedControlDC::memorySize(N)>, public LedControlDC {
+  static_assert(N>=1 && N<=255,"a chain has 1..255 devices");
+  public:
+     LedControlDCT(int dataPin, int clkPin, int csPin, const DCLayout &layout=DC_LAYOUT_DEFAULT):
+     LedControlDC(dataPin,clkPin,csPin,N,layout,(byte *)this->ledMemory){}
+     LedControlDCT(LedTransport &transport, const DCLayout &layout=DC_LAYOUT_DEFAULT):
+     LedControlDC(transport,N,layout,(byte *)this->ledMemory){}
+// The RAM is part of the object, it can not be copied or moved
+     LedControlDCT(const LedControlDCT &)=delete;
+     LedControlDCT(LedControlDCT &&)=delete;
+};
+
+}
+
 #endif	//LedControl.h
@@ -0,0 +1,163 @@
+/*
+ *    LedControlFast.h - LedControl with the pins fixed at compile time
+ *    Copyright (c) 2026 The LedControlDC contributors
+ * 
+ *    Permission is hereby granted, free of charge, to any person
+ *    obtaining a copy of this software and associated documentation
+ *    files (the "Software"), to deal in the Software without
+ *    restriction, including without limitation the rights to use,
+ *    copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *    copies of the Software, and to permit persons to whom the
+ *    Software is furnished to do so, subject to the following
+ *    conditions:
+ * 
+ *    This permission notice shall be included in all copies or 
+ *    substantial portions of the Software.
+ * 
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *    OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+
+#ifndef LedControlFast_h
+#define LedControlFast_h
+
+#include "LedControlDC.h"
+
+/*
+ * Bit-banged transport with the pins as template parameters. The 8 bits
+ * of a byte are shifted without a loop. On AVR the output registers and
+ * bit masks of the pins are looked up once in begin() and kept in 
+ * members, every bit is then a read-modify-write of the port through a
+ * volatile pointer for DIN and two for CLK, with interrupts off for the
+ * whole byte. That saves the pin lookup of digitalWrite(), not the 
+ * pointer. Other boards still make three digitalWrite() calls per bit.
+ */
+template<uint8_t DIN, uint8_t CLK, uint8_t CS>
+class LedFastTransport: public LedTransport {
+    private :
+#if defined(__AVR__)
+        /* The output registers and bit masks of the pins */
+        volatile uint8_t *dinOut;
+        volatile uint8_t *clkOut;
+        volatile uint8_t *csOut;
+        uint8_t dinMask;
+        uint8_t clkMask;
+        uint8_t csMask;
+#endif
+
+        /* Drive the chip select line */
+        inline void select(bool low) {
+#if defined(__AVR__)
+            uint8_t sreg=SREG;
+            cli();
+            if(low)
+                *csOut&=~csMask;
+            else
+                *csOut|=csMask;
+            SREG=sreg;
+#else
+            digitalWrite(CS,low ? LOW : HIGH);
+#endif
+        }
+
+        /* Put one bit on DIN and clock it into the chain */
+        inline void shiftBit(byte value, byte bit) {
+#if defined(__AVR__)
+            if(value & bit)
+                *dinOut|=dinMask;
+            else
+                *dinOut&=~dinMask;
+            *clkOut|=clkMask;
+            *clkOut&=~clkMask;
+#else
+            digitalWrite(DIN,(value & bit) ? HIGH : LOW);
+            digitalWrite(CLK,HIGH);
+            digitalWrite(CLK,LOW);
+#endif
+        }
+
+        /* Shift a byte out MSB first, like shiftOut() */
+        inline void shiftByte(byte value) {
+#if defined(__AVR__)
+            //an interrupt must not change the ports between read and write
+            uint8_t sreg=SREG;
+            cli();
+#endif
+            shiftBit(value,B10000000);
+            shiftBit(value,B01000000);
+            shiftBit(value,B00100000);
+            shiftBit(value,B00010000);
+            shiftBit(value,B00001000);
+            shiftBit(value,B00000100);
+            shiftBit(value,B00000010);
+            shiftBit(value,B00000001);
+#if defined(__AVR__)
+            SREG=sreg;
+#endif
+        }
+
+    public:
+        void begin() {
+            pinMode(DIN,OUTPUT);
+            pinMode(CLK,OUTPUT);
+            pinMode(CS,OUTPUT);
+#if defined(__AVR__)
+            dinOut=portOutputRegister(digitalPinToPort(DIN));
+            clkOut=portOutputRegister(digitalPinToPort(CLK));
+            csOut=portOutputRegister(digitalPinToPort(CS));
+            dinMask=digitalPinToBitMask(DIN);
+            clkMask=digitalPinToBitMask(CLK);
+            csMask=digitalPinToBitMask(CS);
+            //shiftOut() leaves the clock low, so do we
+            *clkOut&=~clkMask;
+#endif
+            select(false);
+        }
+
+        void transfer(const byte *data, int count) {
+            //enable the line 
+            select(true);
+            for(int i=0;i<count;i++)
+                shiftByte(data[i]);
+            //latch the data onto the display
+            select(false);
+        }
+};
+
+/*
+ * A LedControl for N devices on the pins DIN, CLK and CS, with the fast
+ * transport built in. It does everything a LedControl does, a sketch 
+ * only changes the type:
+ *
+ *   LedControl lc=LedControl(12,11,10,1);
+ *   LedControlFast<12,11,10,1> lc;
+ */
+template<uint8_t DIN, uint8_t CLK, uint8_t CS, int N=1>
+class LedControlFast: private LedFastTransport<DIN,CLK,CS>, public LedControlT<N> {
+    public:
+        LedControlFast():
+        LedControlT<N>(static_cast<LedFastTransport<DIN,CLK,CS> &>(*this)) {}
+};
+
+/*
+ * The same for a LedControlDC:
+ *
+ *   LedControlDC lc=LedControlDC(12,11,10);
+ *   LedControlDCFast<12,11,10> lc;
+ */
+template<uint8_t DIN, uint8_t CLK, uint8_t CS, int N=1>
+class LedControlDCFast: private LedFastTransport<DIN,CLK,CS>, public LedControlDCT<N> {
+    public:
+        LedControlDCFast(const DCLayout &layout=DC_LAYOUT_DEFAULT):
+        LedControlDCT<N>(static_cast<LedFastTransport<DIN,CLK,CS> &>(*this),layout) {}
+};
+
+#endif	//LedControlFast.h
@@ -0,0 +1,80 @@
+/*
+ *    LedSPITransport.h - Hardware SPI transport for MAX7219/MAX7221 chains
+ *    Copyright (c) 2026 The LedControlDC contributors
+ * 
+ *    Permission is hereby granted, free of charge, to any person
+ *    obtaining a copy of this software and associated documentation
+ *    files (the "Software"), to deal in the Software without
+ *    restriction, including without limitation the rights to use,
+ *    copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *    copies of the Software, and to permit persons to whom the
+ *    Software is furnished to do so, subject to the following
+ *    conditions:
+ * 
+ *    This permission notice shall be included in all copies or 
+ *    substantial portions of the Software.
+ * 
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *    OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+
+#ifndef LedSPITransport_h
+#define LedSPITransport_h
+
+#include <SPI.h>
+#include "LedTransport.h"
+
+/*
+ * Transport on the hardware SPI of the board. DIN of the first device
+ * goes to MOSI, CLK to SCK and LOAD/CS to any pin. It is kept in its 
+ * own header so sketches that do not use it don't need the SPI library.
+ *
+ *   LedSPITransport spi(10);
+ *   LedControlDC lc=LedControlDC(spi);
+ */
+class LedSPITransport: public LedTransport {
+    private :
+        /* This one is driven LOW for chip selectzion */
+        int SPI_CS;
+        /* The settings for the bus, the MAX7219 runs up to 10MHz */
+        SPISettings settings;
+
+    public:
+        /* 
+         * Create a new transport 
+         * Params :
+         * csPin	pin for selecting the device 
+         * clock	the SPI clock in Hz
+         */
+        LedSPITransport(int csPin, uint32_t clock=8000000):
+        settings(clock,MSBFIRST,SPI_MODE0) {
+            SPI_CS=csPin;
+        }
+
+        void begin() {
+            pinMode(SPI_CS,OUTPUT);
+            digitalWrite(SPI_CS,HIGH);
+            SPI.begin();
+        }
+
+        void transfer(const byte *data, int count) {
+            SPI.beginTransaction(settings);
+            //enable the line 
+            digitalWrite(SPI_CS,LOW);
+            for(int i=0;i<count;i++)
+                SPI.transfer(data[i]);
+            //latch the data onto the display
+            digitalWrite(SPI_CS,HIGH);
+            SPI.endTransaction();
+        }
+};
+
+#endif	//LedSPITransport.h
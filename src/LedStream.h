@@ -0,0 +1,57 @@
+/*
+ *    LedStream.h - Frame streams for MAX7219/MAX7221 chains
+ *    Copyright (c) 2026 The LedControlDC contributors
+ * 
+ *    Permission is hereby granted, free of charge, to any person
+ *    obtaining a copy of this software and associated documentation
+ *    files (the "Software"), to deal in the Software without
+ *    restriction, including without limitation the rights to use,
+ *    copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *    copies of the Software, and to permit persons to whom the
+ *    Software is furnished to do so, subject to the following
+ *    conditions:
+ * 
+ *    This permission notice shall be included in all copies or 
+ *    substantial portions of the Software.
+ * 
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *    OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef LedStream_h
+#define LedStream_h
+
+/*
+ * A frame stream is a precomputed sequence of register writes with its
+ * timing, kept in PROGMEM (or RAM) and shown by LedControl::play(). It 
+ * holds only what changes from one frame to the next, so playing it 
+ * costs no glyph lookup and exactly one transfer per frame record. 
+ * The host build makes streams from print()/animation calls with
+ * LedStreamWriter (extras/host/stream). A stream changes the rows, not
+ * the digit images of LedControlDC: clear() or print() after it.
+ *
+ * A stream is a list of records, each starting with one byte:
+ *
+ * 0x01..0x0F	a frame: the register (opcode), the number n of devices 
+ *		and n pairs of device address and data. The devices not
+ *		listed get a no-op. Devices beyond the chain are skipped.
+ * LED_STREAM_WAIT	2 bytes, the time in ms (low byte first) to wait
+ *		before the next record
+ * LED_STREAM_REPEAT	play the stream from the start again
+ * LED_STREAM_END	the end of the stream
+ *
+ * E.g. digit row 0 of device 1 to 0x7E, 500 ms later row 0 dark again:
+ *   0x01,1, 1,0x7E, LED_STREAM_WAIT,0xF4,0x01, 0x01,1, 1,0x00, LED_STREAM_END
+ */
+#define LED_STREAM_END		0x80
+#define LED_STREAM_WAIT		0x81
+#define LED_STREAM_REPEAT	0x82
+
+#endif	//LedStream.h
@@ -0,0 +1,119 @@
+/*
+ *    LedTransport.cpp - Transports for shifting data to MAX7219/MAX7221 chains
+ *    Copyright (c) 2026 The LedControlDC contributors
+ * 
+ *    Permission is hereby granted, free of charge, to any person
+ *    obtaining a copy of this software and associated documentation
+ *    files (the "Software"), to deal in the Software without
+ *    restriction, including without limitation the rights to use,
+ *    copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *    copies of the Software, and to permit persons to whom the
+ *    Software is furnished to do so, subject to the following
+ *    conditions:
+ * 
+ *    This permission notice shall be included in all copies or 
+ *    substantial portions of the Software.
+ * 
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *    OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+
+#include "LedTransport.h"
+
+LedBitBangTransport::LedBitBangTransport(int dataPin, int clkPin, int csPin) {
+    SPI_MOSI=dataPin;
+    SPI_CLK=clkPin;
+    SPI_CS=csPin;
+}
+
+void LedBitBangTransport::begin() {
+    pinMode(SPI_MOSI,OUTPUT);
+    pinMode(SPI_CLK,OUTPUT);
+    pinMode(SPI_CS,OUTPUT);
+    digitalWrite(SPI_CS,HIGH);
+}
+
+void LedBitBangTransport::transfer(const byte *data, int count) {
+    //enable the line 
+    digitalWrite(SPI_CS,LOW);
+    //Now shift out the data 
+    for(int i=0;i<count;i++)
+        shiftOut(SPI_MOSI,SPI_CLK,MSBFIRST,data[i]);
+    //latch the data onto the display
+    digitalWrite(SPI_CS,HIGH);
+}
+
+LedGroupTransport::LedGroupTransport(LedTransport *const *chains, int count, int devicesPerChain) {
+    this->chains=chains;
+    chainCount=count;
+    devices=devicesPerChain;
+}
+
+void LedGroupTransport::begin() {
+    for(int i=0;i<chainCount;i++)
+        chains[i]->begin();
+}
+
+void LedGroupTransport::transfer(const byte *data, int count) {
+    int size=devices*2;
+
+    //the last device is shifted out first, so the bytes of the last 
+    //chain are at the start of the frame
+    for(int i=0;i<chainCount;i++) {
+        int offset=count-(i+1)*size;
+        if(offset<0)
+            break;
+        for(int j=0;j<size;j+=2) {
+            //select the chain only if one of its devices gets a command
+            if(data[offset+j]!=0) {
+                chains[i]->transfer(data+offset,size);
+                break;
+            }
+        }
+    }
+}
+
+LedRecordingTransport::LedRecordingTransport(byte *buffer, int size) {
+    this->buffer=buffer;
+    this->size=buffer ? size : 0;
+    reset();
+}
+
+void LedRecordingTransport::begin() {
+}
+
+void LedRecordingTransport::transfer(const byte *data, int count) {
+    for(int i=0;i<count;i++) {
+        if(bytes<(unsigned long)size)
+            buffer[bytes]=data[i];
+        bytes++;
+    }
+    frames++;
+}
+
+void LedRecordingTransport::reset() {
+    bytes=0;
+    frames=0;
+}
+
+unsigned long LedRecordingTransport::getFrameCount() {
+    return frames;
+}
+
+unsigned long LedRecordingTransport::getByteCount() {
+    return bytes;
+}
+
+int LedRecordingTransport::getRecordedCount() {
+    if(bytes<(unsigned long)size)
+        return (int)bytes;
+    return size;
+}
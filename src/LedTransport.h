@@ -0,0 +1,177 @@
+/*
+ *    LedTransport.h - Transports for shifting data to MAX7219/MAX7221 chains
+ *    Copyright (c) 2026 The LedControlDC contributors
+ * 
+ *    Permission is hereby granted, free of charge, to any person
+ *    obtaining a copy of this software and associated documentation
+ *    files (the "Software"), to deal in the Software without
+ *    restriction, including without limitation the rights to use,
+ *    copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *    copies of the Software, and to permit persons to whom the
+ *    Software is furnished to do so, subject to the following
+ *    conditions:
+ * 
+ *    This permission notice shall be included in all copies or 
+ *    substantial portions of the Software.
+ * 
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ *    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ *    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ *    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ *    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ *    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ *    OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef LedTransport_h
+#define LedTransport_h
+
+#if (ARDUINO >= 100)
+#include <Arduino.h>
+#else
+#include <WProgram.h>
+#endif
+
+/*
+ * A transport shifts complete frames out to a chain of MAX7219/MAX7221.
+ * LedControl builds the frame, the transport only has to select the 
+ * chain, send the bytes and latch them with the rising edge of the
+ * chip select.
+ */
+class LedTransport {
+    public:
+        virtual ~LedTransport() {}
+
+        /*
+         * Set up the pins (or the bus) used by the transport.
+         * Called once from the constructor of LedControl.
+         */
+        virtual void begin() = 0;
+
+        /*
+         * Send one frame to the chain and latch it.
+         * Params :
+         * data	the bytes of the frame, data[0] is shifted out first
+         * count	the number of bytes in the frame
+         */
+        virtual void transfer(const byte *data, int count) = 0;
+};
+
+/*
+ * Bit-banged transport on three arbitrary pins with shiftOut(). This is 
+ * what LedControl always did, it is used when a LedControl is created 
+ * with pin numbers.
+ */
+class LedBitBangTransport: public LedTransport {
+    private :
+        /* Data is shifted out of this pin*/
+        int SPI_MOSI;
+        /* The clock is signaled on this pin */
+        int SPI_CLK;
+        /* This one is driven LOW for chip selectzion */
+        int SPI_CS;
+
+    public:
+        /* 
+         * Create a new transport 
+         * Params :
+         * dataPin		pin on the Arduino where data gets shifted out
+         * clockPin		pin for the clock
+         * csPin		pin for selecting the device 
+         */
+        LedBitBangTransport(int dataPin, int clkPin, int csPin);
+
+        void begin();
+        void transfer(const byte *data, int count);
+};
+
+/*
+ * Several chains, each on its own chip select line, used as one long 
+ * chain: devices 0..devicesPerChain-1 are the first chain, the next 
+ * devicesPerChain devices the second one and so on. A frame is split 
+ * into one transfer per chain, a chain with only no-ops in the frame 
+ * is not selected at all. The chains may share the data and clock lines,
+ * e.g. LedBitBangTransport(12,11,10) and LedBitBangTransport(12,11,9).
+ */
+class LedGroupTransport: public LedTransport {
+    private :
+        /* The transports of the chains, the first one has device 0 */
+        LedTransport *const *chains;
+        /* The number of chains */
+        int chainCount;
+        /* The number of devices on each chain */
+        int devices;
+
+    public:
+        /* 
+         * Create a new group of chains
+         * Params :
+         * chains	the transports of the chains, must stay valid
+         * count	the number of chains
+         * devicesPerChain	the number of devices on each chain
+         */
+        LedGroupTransport(LedTransport *const *chains, int count, int devicesPerChain);
+
+        void begin();
+        void transfer(const byte *data, int count);
+};
+
+/*
+ * Transport that does not drive any pin but records what would have
+ * been sent. Meant for host builds and tests.
+ */
+class LedRecordingTransport: public LedTransport {
+    private :
+        /* The bytes of the recorded frames, may be NULL */
+        byte *buffer;
+        /* The size of the buffer */
+        int size;
+        /* Number of bytes sent so far */
+        unsigned long bytes;
+        /* Number of frames sent so far */
+        unsigned long frames;
+
+    public:
+        /* 
+         * Create a new recording transport 
+         * Params :
+         * buffer	the frames are appended here until it is full,
+         *		NULL if only the counters are wanted
+         * size	the size of the buffer in bytes
+         */
+        LedRecordingTransport(byte *buffer=NULL, int size=0);
+
+        void begin();
+        void transfer(const byte *data, int count);
+
+        /*
+         * Forget everything recorded so far.
+         */
+        void reset();
+
+        /*
+         * Gets the number of frames sent since the last reset().
+         * Returns :
+         * unsigned long	the number of frames
+         */
+        unsigned long getFrameCount();
+
+        /*
+         * Gets the number of bytes sent since the last reset().
+         * Returns :
+         * unsigned long	the number of bytes
+         */
+        unsigned long getByteCount();
+
+        /*
+         * Gets the number of bytes stored in the buffer. This is less
+         * than getByteCount() once the buffer is full.
+         * Returns :
+         * int	the number of bytes in the buffer
+         */
+        int getRecordedCount();
+};
+
+#endif	//LedTransport.h